@@ -0,0 +1,7 @@
+# Standalone benchmarks of plugin's hot paths (not part of plugin build).
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    parser \
+    findings
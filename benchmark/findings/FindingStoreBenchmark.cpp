@@ -0,0 +1,140 @@
+#include <QtTest>
+
+#include "FindingStore.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  //! Files of project. Findings per file grow with their count.
+  const int fileCount = 1000;
+  //! Distinct checkers and messages of findings.
+  const int checkerCount = 40;
+  const int messageCount = 2000;
+
+  //! Distinct findings, file's unit is file itself.
+  QVector<TaskInfo> findings (int count) {
+    QVector<TaskInfo> result;
+    result.reserve (count);
+    for (int i = 0; i < count; ++i) {
+      TaskInfo info (i % fileCount, i / fileCount + 1, i % checkerCount, i % messageCount);
+      info.addUnit (info.file ());
+      result << info;
+    }
+    return result;
+  }
+
+  //! Storage that FindingStore replaced: duplicates are searched among all file's tasks.
+  class MultiHashStore {
+    public:
+      TaskInfo &insert (const TaskInfo &info, bool &isAdded) {
+        for (auto it = tasks_.find (info.file ()); it != tasks_.end () && it.key () == info.file ();
+             ++it) {
+          if (it.value () == info) {
+            isAdded = false;
+            return it.value ();
+          }
+        }
+        isAdded = true;
+        return tasks_.insert (info.file (), info).value ();
+      }
+      void removeIf (int file, const std::function<bool(TaskInfo &)> &predicate) {
+        for (auto it = tasks_.find (file); it != tasks_.end () && it.key () == file;) {
+          it = predicate (it.value ()) ? tasks_.erase (it) : it + 1;
+        }
+      }
+
+    private:
+      QMultiHash<int, TaskInfo> tasks_;
+  };
+
+  template<class Store>
+  void insert (Store &store, const QVector<TaskInfo> &infos) {
+    bool isAdded = false;
+    for (const auto &info: infos) {
+      store.insert (info, isAdded).addUnit (info.file ());
+    }
+  }
+
+  //! Repeated check of all files that reports same findings.
+  template<class Store>
+  void recheck (Store &store, const QVector<TaskInfo> &infos) {
+    insert (store, infos);
+    for (int file = 0; file < fileCount; ++file) {
+      store.removeIf (file, [file] (TaskInfo &info) {
+        return !info.hasUnit (file);
+      });
+    }
+  }
+}
+
+/*!
+ * \brief Task storage operations of plugin's commitTasks from 1k to 1M findings.
+ */
+class FindingStoreBenchmark : public QObject {
+  Q_OBJECT
+
+  private slots:
+    //! Findings of first check.
+    void insert_data ();
+    void insert ();
+    //! Findings of recheck (all are found again).
+    void recheck_data ();
+    void recheck ();
+};
+
+void FindingStoreBenchmark::insert_data () {
+  QTest::addColumn<bool>("isFindingStore");
+  QTest::addColumn<int>("count");
+  for (auto count: {1000, 10000, 100000, 1000000}) {
+    QTest::newRow (qPrintable (QString::fromLatin1 ("FindingStore %1").arg (count)))
+      << true << count;
+    QTest::newRow (qPrintable (QString::fromLatin1 ("QMultiHash %1").arg (count)))
+      << false << count;
+  }
+}
+
+void FindingStoreBenchmark::insert () {
+  QFETCH (bool, isFindingStore);
+  QFETCH (int, count);
+  const QVector<TaskInfo> infos = findings (count);
+  QBENCHMARK {
+    if (isFindingStore) {
+      FindingStore store;
+      ::insert (store, infos);
+    }
+    else{
+      MultiHashStore store;
+      ::insert (store, infos);
+    }
+  }
+}
+
+void FindingStoreBenchmark::recheck_data () {
+  insert_data ();
+}
+
+void FindingStoreBenchmark::recheck () {
+  QFETCH (bool, isFindingStore);
+  QFETCH (int, count);
+  const QVector<TaskInfo> infos = findings (count);
+  FindingStore findingStore;
+  MultiHashStore multiHashStore;
+  if (isFindingStore) {
+    ::insert (findingStore, infos);
+  }
+  else{
+    ::insert (multiHashStore, infos);
+  }
+  QBENCHMARK {
+    if (isFindingStore) {
+      ::recheck (findingStore, infos);
+    }
+    else{
+      ::recheck (multiHashStore, infos);
+    }
+  }
+}
+
+QTEST_APPLESS_MAIN (FindingStoreBenchmark)
+
+#include "FindingStoreBenchmark.moc"
@@ -0,0 +1,36 @@
+# Scaling of plugin's task storage (FindingStore) from 1k to 1M findings.
+# TaskInfo uses Qt Creator's Task so Qt Creator's paths from paths.pri are required.
+
+include(../../paths.pri)
+
+QT += testlib
+QT -= gui
+
+CONFIG += console testcase c++14
+CONFIG -= app_bundle
+
+TARGET = findings
+
+INCLUDEPATH += \
+    ../../src \
+    $$QTCREATOR_SOURCES/src \
+    $$QTCREATOR_SOURCES/src/libs \
+    $$QTCREATOR_SOURCES/src/plugins
+
+LIBS += \
+    -L$$IDE_BUILD_TREE/lib/qtcreator \
+    -L$$IDE_BUILD_TREE/lib/qtcreator/plugins \
+    -lCore
+
+QMAKE_RPATHDIR += \
+    $$IDE_BUILD_TREE/lib/qtcreator \
+    $$IDE_BUILD_TREE/lib/qtcreator/plugins
+
+SOURCES += \
+    FindingStoreBenchmark.cpp \
+    ../../src/FindingStore.cpp \
+    ../../src/TaskInfo.cpp
+
+HEADERS += \
+    ../../src/FindingStore.h \
+    ../../src/TaskInfo.h
@@ -0,0 +1,73 @@
+#include <QDir>
+
+#include "LegacyXmlOutputParser.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  const QString errorTag = QLatin1String ("error");
+  const QString locationTag = QLatin1String ("location");
+}
+
+LegacyXmlOutputParser::LegacyXmlOutputParser () :
+  isInError_ (false) {
+}
+
+void LegacyXmlOutputParser::reset () {
+  reader_.clear ();
+  current_ = Diagnostic ();
+  isInError_ = false;
+}
+
+void LegacyXmlOutputParser::addData (const QByteArray &data) {
+  reader_.addData (data);
+}
+
+bool LegacyXmlOutputParser::readNext (Diagnostic &diagnostic) {
+  while (!reader_.atEnd ()) {
+    const auto token = reader_.readNext ();
+    if (token == QXmlStreamReader::StartElement) {
+      if (reader_.name () == errorTag) {
+        readError ();
+      }
+      else if (isInError_ && reader_.name () == locationTag) {
+        readLocation ();
+      }
+    }
+    else if (token == QXmlStreamReader::EndElement && isInError_ &&
+             reader_.name () == errorTag) {
+      isInError_ = false;
+      diagnostic = current_;
+      current_ = Diagnostic ();
+      return true;
+    }
+  }
+  // Premature end means that rest of document is not received yet.
+  if (reader_.hasError () && reader_.error () != QXmlStreamReader::PrematureEndOfDocumentError) {
+    reset ();
+  }
+  return false;
+}
+
+void LegacyXmlOutputParser::readError () {
+  const auto attributes = reader_.attributes ();
+  current_ = Diagnostic ();
+  current_.id = attributes.value (QLatin1String ("id")).toString ();
+  current_.severity = attributes.value (QLatin1String ("severity")).toString ();
+  current_.message = attributes.value (QLatin1String ("msg")).toString ();
+  current_.verboseMessage = attributes.value (QLatin1String ("verbose")).toString ();
+  current_.cwe = attributes.value (QLatin1String ("cwe")).toInt ();
+  current_.isInconclusive = (attributes.value (QLatin1String ("inconclusive")) ==
+                             QLatin1String ("true"));
+  isInError_ = true;
+}
+
+void LegacyXmlOutputParser::readLocation () {
+  const auto attributes = reader_.attributes ();
+  DiagnosticLocation location;
+  location.file = QDir::fromNativeSeparators (attributes.value (QLatin1String ("file")).toString ());
+  location.line = attributes.value (QLatin1String ("line")).toInt ();
+  location.column = attributes.value (QLatin1String ("column")).toInt ();
+  location.info = attributes.value (QLatin1String ("info")).toString ();
+  current_.locations.append (location);
+}
@@ -0,0 +1,40 @@
+#ifndef LEGACYXMLOUTPUTPARSER_H
+#define LEGACYXMLOUTPUTPARSER_H
+
+#include <QXmlStreamReader>
+
+#include "Diagnostic.h"
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief QXmlStreamReader based parser of cppcheck's --xml-version=2 output.
+     * Copy of parser that plugin used before XmlOutputParser (to compare with it).
+     */
+    class LegacyXmlOutputParser {
+      public:
+        LegacyXmlOutputParser ();
+
+        //! Prepare for new process' output.
+        void reset ();
+        void addData (const QByteArray &data);
+        //! Read next complete diagnostic. Returns false if more data is required.
+        bool readNext (Diagnostic &diagnostic);
+
+      private:
+        void readError ();
+        void readLocation ();
+
+      private:
+        QXmlStreamReader reader_;
+        //! Diagnostic being read.
+        Diagnostic current_;
+        //! Inside of <error> element.
+        bool isInError_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // LEGACYXMLOUTPUTPARSER_H
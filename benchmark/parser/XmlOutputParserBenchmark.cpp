@@ -0,0 +1,140 @@
+#include <QtTest>
+#include <QFile>
+
+#include "XmlOutputParser.h"
+#include "LegacyXmlOutputParser.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  //! Diagnostics in benchmarked output.
+  const int diagnosticCount = 200000;
+  //! Diagnostics in output of parsers' comparison.
+  const int compareCount = 1000;
+  //! Files in generated output (diagnostics of same file share its path).
+  const int fileGroupCount = 1000;
+  //! Size of one read of process' output (QProcess's read buffer).
+  const int chunkSize = 16 * 1024;
+
+  //! Cppcheck's stderr with at least given number of diagnostics. Recorded output's
+  //! errors are repeated for other directories until there are enough of them.
+  QByteArray repeatedOutput (const QByteArray &recorded, int count) {
+    const int errorsBegin = recorded.indexOf ("<error ");
+    const int errorsEnd = recorded.lastIndexOf ("</error>") + int (qstrlen ("</error>"));
+    if (errorsBegin == -1 || errorsEnd < errorsBegin) {
+      return recorded;
+    }
+    const QByteArray errors = recorded.mid (errorsBegin, errorsEnd - errorsBegin);
+    const int errorCount = errors.count ("<error ");
+    QByteArray result = recorded.left (errorsBegin);
+    result.reserve (recorded.size () + errors.size () * (count / errorCount + 1));
+    for (int i = 0; i * errorCount < count; ++i) {
+      const QByteArray directory = "/home/user/project/module" +
+                                   QByteArray::number (i % fileGroupCount) + '/';
+      QByteArray copy = errors;
+      copy.replace (" file=\"", " file=\"" + directory);
+      copy.replace (" file0=\"", " file0=\"" + directory);
+      result += copy;
+      result += "\n        ";
+    }
+    result += recorded.mid (errorsEnd);
+    return result;
+  }
+
+  //! Feed output to parser by chunks as process' reader does.
+  template<class Parser>
+  int parse (const QByteArray &output, QList<Diagnostic> *diagnostics = NULL) {
+    Parser parser;
+    parser.reset ();
+    Diagnostic diagnostic;
+    int count = 0;
+    for (int i = 0; i < output.size (); i += chunkSize) {
+      parser.addData (output.mid (i, chunkSize));
+      while (parser.readNext (diagnostic)) {
+        ++count;
+        if (diagnostics != NULL) {
+          diagnostics->append (diagnostic);
+        }
+      }
+    }
+    return count;
+  }
+}
+
+/*!
+ * \brief Parsing of cppcheck's --xml-version=2 stderr.
+ * Uses recorded output from QTCCPPCHECK_OUTPUT file if set (as is) or
+ * bundled output.xml repeated to 200k diagnostics.
+ */
+class XmlOutputParserBenchmark : public QObject {
+  Q_OBJECT
+
+  private slots:
+    void initTestCase ();
+    //! Parsers must read same data (XmlOutputParser additionally reads file0).
+    void compare ();
+    void parse_data ();
+    void parse ();
+
+  private:
+    QByteArray output_;
+    QByteArray compareOutput_;
+    int expectedCount_;
+};
+
+void XmlOutputParserBenchmark::initTestCase () {
+  const QString recordedFile = QString::fromLocal8Bit (qgetenv ("QTCCPPCHECK_OUTPUT"));
+  QFile file (!recordedFile.isEmpty () ? recordedFile : QFINDTESTDATA ("output.xml"));
+  QVERIFY2 (file.open (QIODevice::ReadOnly), qPrintable (file.fileName ()));
+  const QByteArray recorded = file.readAll ();
+  output_ = !recordedFile.isEmpty () ? recorded : repeatedOutput (recorded, diagnosticCount);
+  compareOutput_ = !recordedFile.isEmpty () ? recorded : repeatedOutput (recorded, compareCount);
+  expectedCount_ = output_.count ("<error ");
+  QVERIFY (expectedCount_ > 0);
+  qDebug ("%d diagnostics, %d bytes", expectedCount_, output_.size ());
+}
+
+void XmlOutputParserBenchmark::compare () {
+  QList<Diagnostic> scanned;
+  QList<Diagnostic> streamed;
+  parse<XmlOutputParser> (compareOutput_, &scanned);
+  parse<LegacyXmlOutputParser> (compareOutput_, &streamed);
+  QCOMPARE (scanned.size (), streamed.size ());
+  for (int i = 0, end = scanned.size (); i < end; ++i) {
+    const Diagnostic &l = scanned.at (i);
+    const Diagnostic &r = streamed.at (i);
+    QCOMPARE (l.id, r.id);
+    QCOMPARE (l.severity, r.severity);
+    QCOMPARE (l.message, r.message);
+    QCOMPARE (l.verboseMessage, r.verboseMessage);
+    QCOMPARE (l.cwe, r.cwe);
+    QCOMPARE (l.isInconclusive, r.isInconclusive);
+    QCOMPARE (l.locations.size (), r.locations.size ());
+    for (int j = 0, locationsEnd = l.locations.size (); j < locationsEnd; ++j) {
+      QCOMPARE (l.locations.at (j).file, r.locations.at (j).file);
+      QCOMPARE (l.locations.at (j).line, r.locations.at (j).line);
+      QCOMPARE (l.locations.at (j).column, r.locations.at (j).column);
+      QCOMPARE (l.locations.at (j).info, r.locations.at (j).info);
+    }
+  }
+}
+
+void XmlOutputParserBenchmark::parse_data () {
+  QTest::addColumn<bool>("isScanner");
+  QTest::newRow ("XmlOutputParser") << true;
+  QTest::newRow ("QXmlStreamReader") << false;
+}
+
+void XmlOutputParserBenchmark::parse () {
+  QFETCH (bool, isScanner);
+  int count = 0;
+  QBENCHMARK {
+    count = isScanner ? ::parse<XmlOutputParser> (output_)
+            : ::parse<LegacyXmlOutputParser> (output_);
+  }
+  QCOMPARE (count, expectedCount_);
+}
+
+QTEST_APPLESS_MAIN (XmlOutputParserBenchmark)
+
+#include "XmlOutputParserBenchmark.moc"
@@ -0,0 +1,25 @@
+# Parsing of cppcheck's --xml-version=2 output: in place scanner (plugin's one)
+# versus QXmlStreamReader based one it replaced.
+
+QT += testlib
+QT -= gui
+
+CONFIG += console testcase c++14
+CONFIG -= app_bundle
+
+TARGET = parser
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+    XmlOutputParserBenchmark.cpp \
+    LegacyXmlOutputParser.cpp \
+    ../../src/XmlOutputParser.cpp
+
+HEADERS += \
+    LegacyXmlOutputParser.h \
+    ../../src/XmlOutputParser.h \
+    ../../src/Diagnostic.h
+
+OTHER_FILES += \
+    output.xml
@@ -8,17 +8,41 @@ SOURCES += \
     src/OptionsWidget.cpp \
     src/OptionsPage.cpp \
     src/CppcheckRunner.cpp \
+    src/CppcheckWorker.cpp \
+    src/CppcheckProcess.cpp \
+    src/CostModel.cpp \
+    src/ProgressTracker.cpp \
+    src/BuildDirectory.cpp \
+    src/ResultCache.cpp \
+    src/CompilationDatabase.cpp \
+    src/XmlOutputParser.cpp \
     src/Settings.cpp \
     src/TaskInfo.cpp \
+    src/FindingStore.cpp \
+    src/StringTable.cpp \
+    src/PathTable.cpp \
     src/QtcCppcheckPlugin.cpp
 
 HEADERS += \
     src/OptionsWidget.h \
     src/OptionsPage.h \
     src/CppcheckRunner.h \
+    src/CppcheckWorker.h \
+    src/CppcheckProcess.h \
+    src/SpscQueue.h \
+    src/CostModel.h \
+    src/ProgressTracker.h \
+    src/BuildDirectory.h \
+    src/ResultCache.h \
+    src/CompilationDatabase.h \
+    src/Diagnostic.h \
+    src/XmlOutputParser.h \
     src/Settings.h \
     src/Constants.h \
     src/TaskInfo.h \
+    src/FindingStore.h \
+    src/StringTable.h \
+    src/PathTable.h \
     src/QtcCppcheckPlugin.h
 
 FORMS += \
@@ -41,7 +65,8 @@ PROVIDER = Gres
 
 QTC_PLUGIN_NAME = QtcCppcheck
 QTC_LIB_DEPENDS += \
-    utils
+    utils \
+    cplusplus
 
 QTC_PLUGIN_DEPENDS += \
     coreplugin\
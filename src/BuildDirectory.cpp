@@ -0,0 +1,111 @@
+#include <QDir>
+#include <QDirIterator>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+#include <algorithm>
+
+#include "BuildDirectory.h"
+#include "Settings.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  QString hashName (const QString &text) {
+    return QString::fromLatin1 (QCryptographicHash::hash (text.toUtf8 (), QCryptographicHash::Md5)
+                                .toHex ().left (16));
+  }
+
+  struct DirectoryInfo {
+    QString path;
+    qint64 size;
+    QDateTime lastModified;
+  };
+
+  DirectoryInfo directoryInfo (const QString &path) {
+    DirectoryInfo info {path, 0, QDateTime ()};
+    QDirIterator it (path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext ()) {
+      it.next ();
+      const QFileInfo file = it.fileInfo ();
+      info.size += file.size ();
+      if (!info.lastModified.isValid () || info.lastModified < file.lastModified ()) {
+        info.lastModified = file.lastModified ();
+      }
+    }
+    return info;
+  }
+}
+
+BuildDirectory::BuildDirectory () :
+  root_ (Settings::cacheDirectory () + QLatin1String ("/build")) {
+}
+
+void BuildDirectory::setKey (const QString &projectDirectory, const QString &key) {
+  if (projectDirectory.isEmpty ()) {
+    reset ();
+    return;
+  }
+  const QString projectPath = root_ + QLatin1Char ('/') + hashName (projectDirectory);
+  const QString keyName = hashName (key);
+  path_ = projectPath + QLatin1Char ('/') + keyName;
+
+  // Analyzer info of other settings or binary version is useless.
+  QDir project (projectPath);
+  for (const auto &i: project.entryList (QDir::Dirs | QDir::NoDotAndDotDot)) {
+    if (i != keyName) {
+      QDir (project.absoluteFilePath (i)).removeRecursively ();
+    }
+  }
+}
+
+void BuildDirectory::reset () {
+  path_.clear ();
+}
+
+bool BuildDirectory::isValid () const {
+  return !path_.isEmpty ();
+}
+
+int BuildDirectory::slot (const QString &fileName) {
+  return int (qHash (fileName) % slotCount);
+}
+
+QString BuildDirectory::path (int slot) const {
+  Q_ASSERT (isValid ());
+  Q_ASSERT (slot >= 0 && slot <= wholeProgramSlot);
+  const QString name = (slot == wholeProgramSlot) ? QString (QLatin1String ("all"))
+                       : QString::number (slot);
+  const QString slotPath = path_ + QLatin1Char ('/') + name;
+  QDir ().mkpath (slotPath);
+  return slotPath;
+}
+
+void BuildDirectory::limitSize (qint64 maxSize) const {
+  QList<DirectoryInfo> infos;
+  qint64 size = 0;
+  QDir root (root_);
+  for (const auto &project: root.entryInfoList (QDir::Dirs | QDir::NoDotAndDotDot)) {
+    QDir projectDir (project.absoluteFilePath ());
+    for (const auto &key: projectDir.entryInfoList (QDir::Dirs | QDir::NoDotAndDotDot)) {
+      infos << directoryInfo (key.absoluteFilePath ());
+      size += infos.last ().size;
+    }
+  }
+  if (size <= maxSize) {
+    return;
+  }
+  std::sort (infos.begin (), infos.end (), [] (const DirectoryInfo &l, const DirectoryInfo &r) {
+    return l.lastModified < r.lastModified;
+  });
+  for (const auto &i: infos) {
+    if (size <= maxSize) {
+      break;
+    }
+    if (QDir::cleanPath (i.path) == QDir::cleanPath (path_)) { // Could be used by running check.
+      continue;
+    }
+    QDir (i.path).removeRecursively ();
+    size -= i.size;
+  }
+}
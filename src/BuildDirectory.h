@@ -0,0 +1,48 @@
+#ifndef BUILDDIRECTORY_H
+#define BUILDDIRECTORY_H
+
+#include <QString>
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Cppcheck's build directory (--cppcheck-build-dir) of project.
+     * Keeps analyzer info of checked files so unchanged ones are not analyzed again.
+     * Directory is split into slots because cppcheck rewrites its files list on
+     * every run and simultaneous processes must not use same directory.
+     */
+    class BuildDirectory {
+      public:
+        //! Number of slots for separate files.
+        static const int slotCount = 16;
+        //! Slot for checks that use all files at once.
+        static const int wholeProgramSlot = slotCount;
+
+        BuildDirectory ();
+
+        //! Set owner project and key of settings. Removes directories with other keys.
+        void setKey (const QString &projectDirectory, const QString &key);
+        //! Stop using build directory.
+        void reset ();
+        bool isValid () const;
+
+        //! Slot for given file. File always goes to same slot.
+        static int slot (const QString &fileName);
+        //! Directory of given slot. Created if not exists.
+        QString path (int slot) const;
+        //! Remove least recently used directories while summary size exceeds given one.
+        //! Current key's directory is kept.
+        void limitSize (qint64 maxSize) const;
+
+      private:
+        //! Directory of all projects' build directories.
+        QString root_;
+        //! Directory of current key.
+        QString path_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // BUILDDIRECTORY_H
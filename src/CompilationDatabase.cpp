@@ -0,0 +1,174 @@
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cpptools/projectinfo.h>
+#include <cpptools/projectpart.h>
+
+#include "CompilationDatabase.h"
+
+using namespace QtcCppcheck::Internal;
+using namespace CppTools;
+
+namespace {
+  QString standard (ProjectPart::LanguageVersion version) {
+    switch (version) {
+      case ProjectPart::C89: return QLatin1String ("c89");
+      case ProjectPart::C99: return QLatin1String ("c99");
+      case ProjectPart::C11: return QLatin1String ("c11");
+      case ProjectPart::CXX98: // Cppcheck does not distinguish it.
+      case ProjectPart::CXX03: return QLatin1String ("c++03");
+      case ProjectPart::CXX11: return QLatin1String ("c++11");
+      case ProjectPart::CXX14: return QLatin1String ("c++14");
+      case ProjectPart::CXX17: return QLatin1String ("c++17");
+      case ProjectPart::CXX2a: return QLatin1String ("c++20");
+      default: return QString ();
+    }
+  }
+
+  bool isSource (const ProjectFile &file) {
+    return file.kind == ProjectFile::CSource || file.kind == ProjectFile::CXXSource;
+  }
+}
+
+CompilationDatabase::CompilationDatabase () :
+  sourceCount_ (0) {
+}
+
+bool CompilationDatabase::update (const ProjectInfo &info, const QString &projectDirectory) {
+  QCryptographicHash hash (QCryptographicHash::Md5);
+  hash.addData (projectDirectory.toUtf8 ());
+  for (const auto &part: info.projectParts ()) {
+    hash.addData (QByteArray::number (int (part->languageVersion)));
+    for (const auto &macro: part->projectMacros) {
+      hash.addData (macro.toByteArray ());
+    }
+    for (const auto &header: part->headerPaths) {
+      hash.addData (header.path.toUtf8 ());
+    }
+    for (const auto &file: part->files) {
+      hash.addData (QByteArray::number (int (file.kind)));
+      hash.addData (file.path.toUtf8 ());
+    }
+  }
+  const QByteArray signature = hash.result ();
+  if (signature == signature_) {
+    return false;
+  }
+  clear ();
+  signature_ = signature;
+  directory_ = projectDirectory;
+
+  QHash<QString, int> groupIndexes;
+  for (const auto &part: info.projectParts ()) {
+    Group group;
+    group.compiler = part->languageVersion < ProjectPart::CXX98
+                     ? QLatin1String ("cc") : QLatin1String ("c++");
+    for (const auto &macro: part->projectMacros) {
+      if (macro.type == ProjectExplorer::MacroType::Undefine) {
+        group.macros << QLatin1String ("-U") + QString::fromUtf8 (macro.key);
+      }
+      else if (macro.value.isEmpty ()) {
+        group.macros << QLatin1String ("-D") + QString::fromUtf8 (macro.key);
+      }
+      else{
+        group.macros << QLatin1String ("-D") + QString::fromUtf8 (macro.key + '=' + macro.value);
+      }
+    }
+    group.standard = standard (part->languageVersion);
+    // System and out of project headers slow check down too much.
+    for (const auto &header: part->headerPaths) {
+      if (header.type == ProjectExplorer::HeaderPathType::User &&
+          header.path.startsWith (projectDirectory)) {
+        group.includes << header.path;
+      }
+    }
+
+    const QString key = (QStringList {group.compiler, group.standard} + group.macros +
+                         QStringList {QString ()} + group.includes).join (QLatin1Char ('\n'));
+    auto groupIndex = groupIndexes.constFind (key);
+    if (groupIndex == groupIndexes.constEnd ()) {
+      groupIndex = groupIndexes.insert (key, groups_.size ());
+      groups_.append (group);
+    }
+    for (const auto &file: part->files) {
+      if (!files_.contains (file.path)) {
+        files_.insert (file.path, {*groupIndex, isSource (file)});
+        sourceCount_ += isSource (file) ? 1 : 0;
+      }
+    }
+  }
+  return true;
+}
+
+void CompilationDatabase::clear () {
+  groups_.clear ();
+  files_.clear ();
+  signature_.clear ();
+  directory_.clear ();
+  sourceCount_ = 0;
+}
+
+bool CompilationDatabase::isEmpty () const {
+  return sourceCount_ == 0;
+}
+
+bool CompilationDatabase::contains (const QString &fileName) const {
+  auto it = files_.constFind (fileName);
+  return it != files_.constEnd () && it->isSource;
+}
+
+int CompilationDatabase::group (const QString &fileName) const {
+  auto it = files_.constFind (fileName);
+  return it != files_.constEnd () ? it->group : -1;
+}
+
+QByteArray CompilationDatabase::json (const QStringList &fileNames, bool withIncludes) const {
+  QJsonArray commands;
+  for (const auto &file: fileNames) {
+    auto it = files_.constFind (file);
+    if (it == files_.constEnd () || !it->isSource) {
+      continue;
+    }
+    const Group &group = groups_.at (it->group);
+    QStringList arguments = QStringList {group.compiler} + group.macros;
+    if (!group.standard.isEmpty ()) {
+      arguments << QLatin1String ("-std=") + group.standard;
+    }
+    if (withIncludes) {
+      for (const auto &include: group.includes) {
+        arguments << QLatin1String ("-I") << include;
+      }
+    }
+    arguments << file;
+    QJsonObject command;
+    command.insert (QLatin1String ("directory"), directory_);
+    command.insert (QLatin1String ("file"), file);
+    command.insert (QLatin1String ("arguments"), QJsonArray::fromStringList (arguments));
+    commands.append (command);
+  }
+  return QJsonDocument (commands).toJson (QJsonDocument::Compact);
+}
+
+QStringList CompilationDatabase::arguments (int group) const {
+  Q_ASSERT (group >= 0 && group < groups_.size ());
+  const Group &flags = groups_.at (group);
+  QStringList arguments = flags.macros;
+  if (!flags.standard.isEmpty ()) {
+    arguments << QLatin1String ("--std=") + flags.standard;
+  }
+  // Headers' language is guessed from suffix (.h is C) otherwise.
+  arguments << (flags.compiler == QLatin1String ("cc") ? QLatin1String ("--language=c")
+                : QLatin1String ("--language=c++"));
+  return arguments;
+}
+
+QStringList CompilationDatabase::includes (int group) const {
+  Q_ASSERT (group >= 0 && group < groups_.size ());
+  QStringList includes;
+  for (const auto &include: groups_.at (group).includes) {
+    includes << QLatin1String ("-I") + include;
+  }
+  return includes;
+}
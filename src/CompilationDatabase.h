@@ -0,0 +1,73 @@
+#ifndef COMPILATIONDATABASE_H
+#define COMPILATIONDATABASE_H
+
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+
+namespace CppTools {
+  class ProjectInfo;
+}
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Compilation database (compile_commands.json) of project's sources.
+     * Built from code model's project parts. Passed to cppcheck via --project
+     * so each file is checked with its own defines instead of all configurations.
+     * Headers are not included because cppcheck skips them in projects.
+     * Files of parts with same defines, includes, standard and language
+     * share one flag group. Headers are checked with their group's arguments.
+     */
+    class CompilationDatabase {
+      public:
+        CompilationDatabase ();
+
+        //! Rebuild entries if project parts have changed. Returns true if rebuilt.
+        bool update (const CppTools::ProjectInfo &info, const QString &projectDirectory);
+        void clear ();
+
+        bool isEmpty () const;
+        //! File is a source with database entry.
+        bool contains (const QString &fileName) const;
+        //! Flag group of file (source or header) or -1 if file is not in project parts.
+        int group (const QString &fileName) const;
+        //! Database of given files. Files without entries are skipped.
+        QByteArray json (const QStringList &fileNames, bool withIncludes) const;
+        //! Cppcheck's arguments for files of group when checked without database.
+        QStringList arguments (int group) const;
+        //! Cppcheck's include arguments (-I<path>) of group.
+        QStringList includes (int group) const;
+
+      private:
+        struct Group {
+          //! Compiler (cc or c++).
+          QString compiler;
+          //! Defines (-D) and undefines (-U).
+          QStringList macros;
+          QString standard;
+          //! Include paths.
+          QStringList includes;
+        };
+        struct File {
+          int group;
+          bool isSource;
+        };
+
+      private:
+        //! Flag groups by index.
+        QVector<Group> groups_;
+        //! Sources and headers by file names.
+        QHash<QString, File> files_;
+        //! Hash of project parts data groups_ are built from.
+        QByteArray signature_;
+        QString directory_;
+        //! Number of sources in files_.
+        int sourceCount_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // COMPILATIONDATABASE_H
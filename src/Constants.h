@@ -23,11 +23,18 @@ namespace QtcCppcheck {
     const char SETTINGS_SHOW_ID[] = "showId";
     const char SETTINGS_POPUP_ON_ERROR[] = "popupOnError";
     const char SETTINGS_POPUP_ON_WARNING[] = "popupOnWarning";
+    const char SETTINGS_INCREMENTAL_CHECK[] = "incrementalCheck";
+    const char SETTINGS_CACHE_SIZE_LIMIT[] = "cacheSizeLimit";
+    const char SETTINGS_DEPENDENTS_LIMIT[] = "dependentsLimit";
+    const char SETTINGS_SKIP_EXTERNAL[] = "skipExternal";
+    const char SETTINGS_VENDOR_DIRECTORIES[] = "vendorDirectories";
 
     const char TASK_CATEGORY_ID[] = "QtcCppcheck.TaskCategory";
     const char TASK_CATEGORY_NAME[] = "Cppcheck";
 
     const char TASK_CHECKING[] = "Cppcheck.Task.Checking";
+    //! Checked file of whole program check's results (not a real file).
+    const char WHOLE_PROGRAM_UNIT[] = "Cppcheck.WholeProgram";
 
     const char MENU_ID[] = "Cppcheck.Menu";
     const char ACTION_CHECK_NODE_ID[] = "Cppcheck.CheckCurrentNode";
@@ -0,0 +1,143 @@
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+
+#include "CostModel.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  const quint32 storeVersion = 3;
+  //! Drop measures of other arguments when store becomes bigger.
+  const int maxStoreSize = 200000;
+  //! Cost of file when nothing is measured.
+  const int defaultCost = 1000;
+}
+
+CostModel::CostModel (const QString &storeFileName) :
+  storeFileName_ (storeFileName), argumentsHash_ (0), currentCosts_ (NULL),
+  totalCost_ (0), isModified_ (false) {
+  load ();
+}
+
+CostModel::~CostModel () {
+  save ();
+}
+
+void CostModel::setArgumentsHash (uint hash) {
+  argumentsHash_ = hash;
+  currentCosts_ = &costs_[argumentsHash_];
+  updateTotalCost ();
+}
+
+int CostModel::cost (const QString &fileName) const {
+  const int measured = measuredCost (fileName);
+  return (measured != -1) ? measured : averageCost ();
+}
+
+int CostModel::measuredCost (const QString &fileName) const {
+  Q_ASSERT (currentCosts_ != NULL);
+  return currentCosts_->value (fileName, -1);
+}
+
+int CostModel::averageCost () const {
+  Q_ASSERT (currentCosts_ != NULL);
+  return currentCosts_->isEmpty () ? defaultCost : int (totalCost_ / currentCosts_->size ());
+}
+
+void CostModel::addMeasure (const QString &fileName, int elapsedMs) {
+  Q_ASSERT (currentCosts_ != NULL);
+  int &cost = (*currentCosts_)[fileName];
+  totalCost_ -= cost;
+  // Smooth measure noise.
+  cost = (cost > 0) ? (cost + elapsedMs) / 2 : elapsedMs;
+  totalCost_ += cost;
+  isModified_ = true;
+}
+
+int CostModel::maxConfigs (const QString &fileName) const {
+  return maxConfigs_.value (fileName, 0);
+}
+
+void CostModel::setMaxConfigs (const QString &fileName, int maxConfigs) {
+  if (maxConfigs > 0) {
+    maxConfigs_.insert (fileName, maxConfigs);
+  }
+  else{
+    maxConfigs_.remove (fileName);
+  }
+  isModified_ = true;
+}
+
+QStringList CostModel::configurations (const QString &fileName) const {
+  return configurations_.value (fileName);
+}
+
+void CostModel::setConfigurations (const QString &fileName, const QStringList &configurations) {
+  auto it = configurations_.find (fileName);
+  if (it == configurations_.end () ? configurations.isEmpty () : *it == configurations) {
+    return;
+  }
+  if (configurations.isEmpty ()) {
+    configurations_.erase (it);
+  }
+  else{
+    configurations_.insert (fileName, configurations);
+  }
+  isModified_ = true;
+}
+
+void CostModel::load () {
+  costs_.clear ();
+  maxConfigs_.clear ();
+  configurations_.clear ();
+  QFile file (storeFileName_);
+  if (file.open (QIODevice::ReadOnly)) {
+    QDataStream stream (&file);
+    quint32 version = 0;
+    stream >> version;
+    if (version == storeVersion) {
+      stream >> costs_ >> maxConfigs_ >> configurations_;
+      if (stream.status () != QDataStream::Ok) {
+        costs_.clear ();
+        maxConfigs_.clear ();
+        configurations_.clear ();
+      }
+    }
+  }
+  isModified_ = false;
+  setArgumentsHash (argumentsHash_);
+}
+
+void CostModel::save () {
+  if (!isModified_) {
+    return;
+  }
+  int size = 0;
+  for (const auto &i: costs_) {
+    size += i.size ();
+  }
+  if (size > maxStoreSize) {
+    Costs current = *currentCosts_;
+    costs_.clear ();
+    costs_.insert (argumentsHash_, current);
+    currentCosts_ = &costs_[argumentsHash_];
+  }
+  QDir ().mkpath (QFileInfo (storeFileName_).absolutePath ());
+  QFile file (storeFileName_);
+  if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return;
+  }
+  QDataStream stream (&file);
+  stream << storeVersion << costs_ << maxConfigs_ << configurations_;
+  isModified_ = false;
+}
+
+void CostModel::updateTotalCost () {
+  Q_ASSERT (currentCosts_ != NULL);
+  totalCost_ = 0;
+  for (auto cost: *currentCosts_) {
+    totalCost_ += cost;
+  }
+}
@@ -0,0 +1,71 @@
+#ifndef COSTMODEL_H
+#define COSTMODEL_H
+
+#include <QHash>
+#include <QStringList>
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Historical check time of files.
+     * Keeps measured times by file name and run arguments hash.
+     * Used to order check queue and to predict check duration.
+     * Also remembers configurations of files and files that are checked
+     * with limited configurations.
+     */
+    class CostModel {
+      public:
+        explicit CostModel (const QString &storeFileName);
+        ~CostModel ();
+
+        //! Set hash of arguments that affect check time.
+        void setArgumentsHash (uint hash);
+
+        //! Predicted check time of file in ms. Average time if not measured yet.
+        int cost (const QString &fileName) const;
+        //! Measured check time of file in ms. -1 if not measured yet.
+        int measuredCost (const QString &fileName) const;
+        //! Predicted check time of not measured file in ms.
+        int averageCost () const;
+        //! Remember measured check time of file.
+        void addMeasure (const QString &fileName, int elapsedMs);
+
+        //! Limit of checked configurations of file. 0 if not limited.
+        int maxConfigs (const QString &fileName) const;
+        //! Remember limit for file that is too slow to check all configurations.
+        void setMaxConfigs (const QString &fileName, int maxConfigs);
+
+        //! Not default configurations found by last full check of file.
+        QStringList configurations (const QString &fileName) const;
+        void setConfigurations (const QString &fileName, const QStringList &configurations);
+
+        void load ();
+        void save ();
+
+      private:
+        typedef QHash<QString, int> Costs;
+
+        void updateTotalCost ();
+
+      private:
+        //! Persistent store.
+        QString storeFileName_;
+        uint argumentsHash_;
+        //! Check times by arguments hash and file name.
+        QHash<uint, Costs> costs_;
+        //! Check times for current arguments.
+        Costs *currentCosts_;
+        //! Sum of currentCosts_ values (for average).
+        qint64 totalCost_;
+        //! Configuration limits by file name (degraded check mode).
+        QHash<QString, int> maxConfigs_;
+        //! Configurations of files that have them.
+        QHash<QString, QStringList> configurations_;
+        bool isModified_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // COSTMODEL_H
@@ -0,0 +1,210 @@
+#include <QDir>
+#include <QFileInfo>
+
+#include "CppcheckProcess.h"
+
+using namespace QtcCppcheck::Internal;
+
+CppcheckProcess::CppcheckProcess (QObject *parent) :
+  QObject (parent), process_ (this), showOutput_ (false), isCanceled_ (false),
+  isNotified_ (0) {
+  connect (&process_, &QProcess::readyReadStandardOutput,
+           this, &CppcheckProcess::readOutput);
+  connect (&process_, &QProcess::readyReadStandardError,
+           this, &CppcheckProcess::readError);
+  connect (&process_, &QProcess::started,
+           this, &CppcheckProcess::started);
+  connect (&process_, &QProcess::errorOccurred,
+           this, &CppcheckProcess::error);
+  connect (&process_, static_cast<void (QProcess::*)(int)>(&QProcess::finished),
+           this, &CppcheckProcess::processFinished);
+}
+
+bool CppcheckProcess::takeEvent (Event &event) {
+  return events_.pop (event);
+}
+
+void CppcheckProcess::resetNotification () {
+  isNotified_.storeRelease (0);
+}
+
+void CppcheckProcess::start (const QString &binary, const QStringList &arguments,
+                             bool showOutput) {
+  Q_ASSERT (!process_.isOpen ());
+  showOutput_ = showOutput;
+  isCanceled_ = false;
+  currentFile_.clear ();
+  configurations_.clear ();
+  reportedKeys_.clear ();
+  existingFiles_.clear ();
+  parser_.reset ();
+  process_.start (binary, arguments);
+}
+
+void CppcheckProcess::kill () {
+  if (process_.isOpen ()) {
+    isCanceled_ = true;
+    process_.kill ();
+  }
+}
+
+void CppcheckProcess::push (const Event &event) {
+  events_.push (event);
+  if (isNotified_.testAndSetOrdered (0, 1)) {
+    emit eventsQueued ();
+  }
+}
+
+void CppcheckProcess::pushOutput (const QString &text) {
+  Event event;
+  event.type = Event::OutputWritten;
+  event.text = text;
+  push (event);
+}
+
+void CppcheckProcess::readOutput () {
+  process_.setReadChannel (QProcess::StandardOutput);
+
+  QString output;
+  while (!process_.atEnd () && process_.canReadLine ()) {
+    QByteArray rawLine = process_.readLine ();
+    QString line = QString::fromUtf8 (rawLine).trimmed ();
+    if (line.isEmpty ()) {
+      continue;
+    }
+    // "N/M files checked P% done" after each file except single one.
+    const QString progressSample = QLatin1String (" files checked ");
+    // "Checking <file> ..." (configuration lines are "Checking <file>: <cfg>...").
+    const QString checkingSample = QLatin1String ("Checking ");
+    const QString fileStartSample = QLatin1String (" ...");
+    const QString configurationEndSample = QLatin1String ("...");
+    if (line.contains (progressSample)) {
+      finishFile ();
+    }
+    else if (line.startsWith (checkingSample) && line.endsWith (fileStartSample)) {
+      finishFile ();
+      int fileLength = line.length () - checkingSample.length () - fileStartSample.length ();
+      currentFile_ = QDir::fromNativeSeparators (line.mid (checkingSample.length (), fileLength));
+      fileTimer_.start ();
+      Event event;
+      event.type = Event::FileStarted;
+      event.text = currentFile_;
+      push (event);
+    }
+    else if (line.startsWith (checkingSample) && line.endsWith (configurationEndSample) &&
+             !currentFile_.isEmpty ()) {
+      // "Checking <file>: <cfg>..." where cfg is "A;B=1".
+      const int configurationIndex = checkingSample.length () + currentFile_.length () + 2;
+      configurations_ << line.mid (configurationIndex,
+                                   line.length () - configurationIndex - configurationEndSample.length ());
+      Event event;
+      event.type = Event::ConfigurationStarted;
+      event.text = configurations_.last ();
+      push (event);
+    }
+    if (showOutput_) {
+      output += line + QLatin1Char ('\n');
+    }
+  }
+  if (!output.isEmpty ()) {
+    output.chop (1);
+    pushOutput (output);
+  }
+}
+
+void CppcheckProcess::finishFile () {
+  if (!currentFile_.isEmpty ()) {
+    // Cppcheck writes file's errors before its progress line, take already read ones.
+    readError ();
+    Event event;
+    event.type = Event::FileChecked;
+    event.text = currentFile_;
+    event.value = int (fileTimer_.elapsed ());
+    event.configurations = configurations_;
+    push (event);
+    currentFile_.clear ();
+    configurations_.clear ();
+  }
+}
+
+void CppcheckProcess::readError () {
+  // Diagnostics are parsed as soon as their XML elements are complete.
+  QByteArray data = process_.readAllStandardError ();
+  if (data.isEmpty ()) {
+    return;
+  }
+  if (showOutput_) {
+    pushOutput (QString::fromUtf8 (data).trimmed ());
+  }
+  parser_.addData (data);
+  Event event;
+  event.type = Event::DiagnosticFound;
+  while (parser_.readNext (event.diagnostic)) {
+    if (isShown (event.diagnostic)) {
+      push (event);
+    }
+  }
+}
+
+bool CppcheckProcess::isShown (const Diagnostic &diagnostic) {
+  // Tasks can be added only to files.
+  const QString file = diagnostic.file ();
+  auto exists = existingFiles_.constFind (file);
+  if (exists == existingFiles_.constEnd ()) {
+    exists = existingFiles_.insert (file, !file.isEmpty () && QFileInfo::exists (file));
+  }
+  if (!exists.value ()) {
+    return false;
+  }
+  const QString key = diagnostic.checkedFile + QLatin1Char ('\n') + file + QLatin1Char ('\n') +
+                      QString::number (diagnostic.line ()) + QLatin1Char ('\n') +
+                      diagnostic.id + QLatin1Char ('\n') + diagnostic.message;
+  if (reportedKeys_.contains (key)) {
+    return false;
+  }
+  reportedKeys_.insert (key);
+  return true;
+}
+
+void CppcheckProcess::started () {
+  if (showOutput_) {
+    pushOutput (tr ("Cppcheck started"));
+  }
+}
+
+void CppcheckProcess::error (QProcess::ProcessError error) {
+  if (showOutput_) {
+    pushOutput (tr ("Cppcheck error occured"));
+  }
+  if (error == QProcess::FailedToStart) {
+    Event event;
+    event.type = Event::StartFailed;
+    push (event);
+    isCanceled_ = true;
+    processFinished ();
+  }
+}
+
+void CppcheckProcess::processFinished () {
+  const bool hasCrashed = !isCanceled_ && (process_.exitStatus () == QProcess::CrashExit ||
+                                           process_.exitCode () != 0);
+  if (!isCanceled_) {
+    readError ();
+    readOutput ();
+    // Single file is checked without progress output.
+    // Current file of crashed process is not done.
+    if (!hasCrashed) {
+      finishFile ();
+    }
+  }
+  currentFile_.clear ();
+  configurations_.clear ();
+  Event event;
+  event.type = Event::Finished;
+  event.value = hasCrashed ? 1 : 0;
+  process_.close ();
+  if (showOutput_) {
+    pushOutput (tr ("Cppcheck finished"));
+  }
+  push (event);
+}
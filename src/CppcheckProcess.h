@@ -0,0 +1,99 @@
+#ifndef CPPCHECKPROCESS_H
+#define CPPCHECKPROCESS_H
+
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QSet>
+#include <QHash>
+
+#include "Diagnostic.h"
+#include "XmlOutputParser.h"
+#include "SpscQueue.h"
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Cppcheck process of CppcheckWorker that lives in I/O thread.
+     * Reads and parses process' output, passes results to worker's thread
+     * via lock-free queue. Worker is notified once until it takes events.
+     * Controlled only with queued invocations of its slots.
+     */
+    class CppcheckProcess : public QObject {
+      Q_OBJECT
+
+      public:
+        struct Event {
+          enum Type {
+            FileStarted, ConfigurationStarted, FileChecked, DiagnosticFound,
+            OutputWritten, StartFailed, Finished
+          };
+          Event () : type (Finished), value (0) {}
+
+          Type type;
+          //! File name, configuration or output text.
+          QString text;
+          //! Check time of file in ms (FileChecked).
+          //! 1 if process crashed or exited with error code (Finished).
+          int value;
+          //! Not default configurations of checked file.
+          QStringList configurations;
+          Diagnostic diagnostic;
+        };
+
+        explicit CppcheckProcess (QObject *parent = 0);
+
+        //! Take next event. For worker's thread.
+        bool takeEvent (Event &event);
+        //! Allow eventsQueued () notification. For worker's thread (before taking events).
+        void resetNotification ();
+
+      public slots:
+        void start (const QString &binary, const QStringList &arguments, bool showOutput);
+        void kill ();
+
+      signals:
+        //! There are events to take.
+        void eventsQueued ();
+
+      private slots:
+        void readOutput ();
+        void readError ();
+        void started ();
+        void error (QProcess::ProcessError error);
+        void processFinished ();
+
+      private:
+        void push (const Event &event);
+        void pushOutput (const QString &text);
+        //! Report check time of currentFile_ if any.
+        void finishFile ();
+        //! Diagnostic is not reported yet and points to existing file.
+        bool isShown (const Diagnostic &diagnostic);
+
+      private:
+        QProcess process_;
+        XmlOutputParser parser_;
+        //! File being checked now (from process' output).
+        QString currentFile_;
+        //! Not default configurations of currentFile_.
+        QStringList configurations_;
+        //! Check time of currentFile_.
+        QElapsedTimer fileTimer_;
+        bool showOutput_;
+        //! Process was killed.
+        bool isCanceled_;
+        //! Keys of reported diagnostics (each configuration reports same ones again).
+        QSet<QString> reportedKeys_;
+        //! Existence of diagnostics' files.
+        QHash<QString, bool> existingFiles_;
+        SpscQueue<Event> events_;
+        //! Worker is notified about not taken events.
+        QAtomicInt isNotified_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // CPPCHECKPROCESS_H
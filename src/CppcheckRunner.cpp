@@ -3,28 +3,54 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QThread>
+#include <QProcess>
+
+#include <algorithm>
+#include <iterator>
 
 #include <coreplugin/messagemanager.h>
 #include <coreplugin/progressmanager/progressmanager.h>
 #include <coreplugin/progressmanager/futureprogress.h>
 #include <utils/macroexpander.h>
+#include <utils/runextensions.h>
 
 #include "CppcheckRunner.h"
+#include "CppcheckWorker.h"
 #include "Constants.h"
 #include "Settings.h"
+#include "PathTable.h"
 
 using namespace QtcCppcheck::Internal;
 
 namespace {
-  enum ErrorField {
-    ErrorFieldFile = 0, ErrorFieldLine, ErrorFieldSeverity, ErrorFieldId,
-    ErrorFieldMessage
-  };
+  //! Files that are checked longer get less configurations next time.
+  const int slowFileMs = 30000;
+  //! Configuration limits of degraded check, tightened one by one.
+  const int maxConfigsSteps[] = {4, 1};
+  //! Tasks are emitted in batches by count or time.
+  const int maxTaskBatchSize = 1000;
+  const int taskBatchDelayMs = 100;
+  //! Interactive files checked by configurations in parallel.
+  const int minSplitCostMs = 5000;
+  const int minSplitConfigurations = 3;
+  //! Project files are looked up in result cache by parts to start checking sooner.
+  const int lookupBatchSize = 256;
+  //! Caches' size is limited not more often than this.
+  const int cacheMaintenanceIntervalMs = 60000;
+
+  QString durationText (qint64 ms) {
+    const qint64 seconds = ms / 1000;
+    return QString::fromLatin1 ("%1:%2").arg (seconds / 60).arg (seconds % 60, 2, 10, QLatin1Char ('0'));
+  }
 }
 
-CppcheckRunner::CppcheckRunner (Settings *settings, QObject *parent) :
-  QObject (parent), settings_ (settings), showOutput_ (false), showId_ (false), futureInterface_ (NULL),
-  maxArgumentsLength_ (0) {
+CppcheckRunner::CppcheckRunner (Settings *settings, PathTable *paths, QObject *parent) :
+  QObject (parent), reservedWorkerCount_ (1), projectWorkerCount_ (1), settings_ (settings),
+  paths_ (paths),
+  costModel_ (Settings::cacheDirectory () + QLatin1String ("/costs.dat")),
+  resultCache_ (Settings::cacheDirectory () + QLatin1String ("/results")),
+  lastLookup_ (0), showOutput_ (false),
+  futureInterface_ (NULL), maxArgumentsLength_ (0) {
 #ifdef __linux__
   QProcess getConf;
   getConf.start (QLatin1String ("getconf ARG_MAX"));
@@ -35,36 +61,87 @@ CppcheckRunner::CppcheckRunner (Settings *settings, QObject *parent) :
   maxArgumentsLength_ = 32767;
 #endif
   Q_ASSERT (settings_ != NULL);
+  Q_ASSERT (paths_ != NULL);
+
+  tasksTimer_.setSingleShot (true);
+  tasksTimer_.setInterval (taskBatchDelayMs);
+  connect (&tasksTimer_, &QTimer::timeout,
+           this, &CppcheckRunner::flushTasks);
+
+  slowFilesTimer_.setInterval (1000);
+  connect (&slowFilesTimer_, &QTimer::timeout,
+           this, &CppcheckRunner::checkSlowFiles);
 
-  connect (&process_, &QProcess::readyReadStandardOutput,
-           this, &CppcheckRunner::readOutput);
-  connect (&process_, &QProcess::readyReadStandardError,
-           this, &CppcheckRunner::readError);
-  connect (&process_, &QProcess::started,
-           this, &CppcheckRunner::started);
-  connect (&process_, &QProcess::errorOccurred,
-           this, &CppcheckRunner::error);
-  connect (&process_, static_cast<void (QProcess::*)(int)>(&QProcess::finished),
-           this, &CppcheckRunner::finished);
+  // Processes' output is read and parsed in separate thread to not slow down UI.
+  ioThread_.setObjectName (QLatin1String ("QtcCppcheck I/O"));
+  ioThread_.start ();
 
-  // Restart checking if got queue.
-  connect (&process_, static_cast<void (QProcess::*)(int)>(&QProcess::finished),
-           this, &CppcheckRunner::checkQueuedFiles);
+  // Single thread keeps cache tasks in order without locks.
+  cachePool_.setMaxThreadCount (1);
+  ResultCache *cache = &resultCache_;
+  Utils::runAsync (&cachePool_, [cache] {cache->load ();});
+
+  // Reserved workers do not increase processes count if there are enough cores.
+  const int coreCount = std::max (QThread::idealThreadCount (), 1);
+  const int poolSize = reservedWorkerCount_ + std::max (coreCount - reservedWorkerCount_, 1);
+  for (int i = 0; i < poolSize; ++i) {
+    auto worker = new CppcheckWorker (&ioThread_, this);
+    connect (worker, &CppcheckWorker::newTasks,
+             this, [this, worker] (const QList<Diagnostic> &diagnostics) {
+      addTasks (worker, diagnostics);
+    });
+    connect (worker, &CppcheckWorker::progressChanged,
+             this, &CppcheckRunner::updateProgress);
+    connect (worker, &CppcheckWorker::fileChecked,
+             this, [this, worker] (const QString &fileName, int elapsedMs,
+                                   const QStringList &configurations) {
+      const qint64 cost = fileCost (worker, fileName);
+      progressTracker_.addDone (cost);
+      workerCosts_[worker] -= cost;
+      const Lane *lane = workerLanes_.value (worker);
+      if (lane == &unusedLane_ || lane == &configLane_) { // Not full checks.
+        return;
+      }
+      commitFile (worker, fileName);
+      costModel_.addMeasure (fileName, elapsedMs);
+      invalidateFileInfo (fileName);
+      // Flags of group pin configuration.
+      if (costModel_.maxConfigs (fileName) == 0 && compilationDatabase_.group (fileName) == -1) {
+        costModel_.setConfigurations (fileName, configurations);
+      }
+    });
+    connect (worker, &CppcheckWorker::finished,
+             this, [this, worker] {workerFinished (worker);});
+    workers_ << worker;
+  }
 }
 
 CppcheckRunner::~CppcheckRunner () {
-  if (process_.isOpen ()) {
-    process_.kill ();
+  for (auto worker: workers_) {
+    worker->disconnect (this);
+    worker->kill ();
   }
   queueTimer_.stop ();
+  // Deletes workers' processes (that kill running binaries).
+  ioThread_.quit ();
+  ioThread_.wait ();
+  // Result cache is saved after its last task.
+  for (auto watcher: lookupWatchers_) {
+    watcher->disconnect (this);
+    watcher->cancel ();
+  }
+  cachePool_.waitForDone ();
   settings_ = NULL;
+  paths_ = NULL;
   delete futureInterface_;
 }
 
 void CppcheckRunner::updateSettings () {
   Q_ASSERT (settings_ != NULL);
   showOutput_ = settings_->showBinaryOutput ();
-  showId_ = settings_->showId ();
+  for (auto worker: workers_) {
+    worker->setShowOutput (showOutput_);
+  }
   runArguments_.clear ();
   QString enabled = QLatin1String ("--enable=warning,style,performance,"
                                    "portability,information,missingInclude");
@@ -75,39 +152,220 @@ void CppcheckRunner::updateSettings () {
       break;
     }
   }
-  if (settings_->checkUnused ()) {
-    enabled += QLatin1String (",unusedFunction");
-  }
-  else{ //TODO always check with threads but rescan for unused after finish?
-    runArguments_ << (QLatin1String ("-j ") +
-                      QString::number (QThread::idealThreadCount ()));
-  }
+  projectWorkerCount_ = workers_.size () - reservedWorkerCount_;
   runArguments_ << enabled;
+
+  // Unused functions are searched by separate whole program check.
+  unusedArguments_.clear ();
+  unusedArguments_ << QLatin1String ("--enable=unusedFunction");
+  if (!settings_->checkUnused ()) {
+    unusedLane_ = Lane ();
+  }
+
+  QStringList commonArguments;
   if (settings_->checkInconclusive ()) {
-    runArguments_ << QLatin1String ("--inconclusive");
+    commonArguments << QLatin1String ("--inconclusive");
   }
-  runArguments_ << QLatin1String ("--template={file},{line},{severity},{id},{message}");
+  commonArguments << QLatin1String ("--xml") << QLatin1String ("--xml-version=2");
+  runArguments_ += commonArguments;
+  unusedArguments_ += commonArguments;
+
+  costModel_.setArgumentsHash (qHash (runArguments_.join (QLatin1Char (' ')) +
+                                      settings_->customParameters ()));
+  fileInfos_.clear ();
+
+  binaryVersion_.clear ();
+  if (settings_->incrementalCheck () && !settings_->binaryFile ().isEmpty ()) {
+    QProcess versionProcess;
+    versionProcess.start (settings_->binaryFile (), QStringList () << QLatin1String ("--version"));
+    versionProcess.waitForFinished (2000);
+    binaryVersion_ = QString::fromUtf8 (versionProcess.readAllStandardOutput ()).trimmed ();
+  }
+  cacheArguments_.clear ();
+  if (!binaryVersion_.isEmpty ()) {
+    cacheArguments_ = settings_->binaryFile () + QLatin1Char ('\n') + binaryVersion_ +
+                      QLatin1Char ('\n') + runArguments_.join (QLatin1Char (' '));
+  }
+  cacheRequests_.clear (); // Arguments could be changed.
+  updateBuildDirectory ();
 }
 
 void CppcheckRunner::setIncludePaths (const QStringList &paths) {
-  includePaths_.clear ();
-  includePaths_.reserve (paths.size ());
-  for (const auto &i: paths) {
-    includePaths_.append (QLatin1String ("-I") + i);
+  const QVector<int> includePaths = paths_->intern (paths);
+  if (includePaths != includePaths_) {
+    includePaths_ = includePaths;
+    cacheRequests_.clear ();
+  }
+}
+
+QStringList CppcheckRunner::includeArguments () const {
+  QStringList arguments;
+  arguments.reserve (includePaths_.size ());
+  for (auto i: includePaths_) {
+    arguments.append (QLatin1String ("-I") + paths_->path (i));
+  }
+  return arguments;
+}
+
+void CppcheckRunner::setProjectDirectory (const QString &directory) {
+  projectDirectory_ = directory;
+  if (projectDirectory_.isEmpty ()) {
+    compilationDatabase_.clear ();
+    cacheRequests_.clear ();
+    fileInfos_.clear ();
   }
+  updateBuildDirectory ();
 }
 
-void CppcheckRunner::checkFiles (const QStringList &fileNames) {
+void CppcheckRunner::setProjectInfo (const CppTools::ProjectInfo &info,
+                                     const QString &projectDirectory) {
+  if (!compilationDatabase_.update (info, projectDirectory)) {
+    return;
+  }
+  cacheRequests_.clear ();
+  fileInfos_.clear ();
+  if (showOutput_) {
+    Core::MessageManager::write (tr ("Cppcheck compilation database updated"),
+                                 Core::MessageManager::Silent);
+  }
+}
+
+void CppcheckRunner::updateBuildDirectory () {
+  Q_ASSERT (settings_ != NULL);
+  if (binaryVersion_.isEmpty () || projectDirectory_.isEmpty ()) {
+    buildDirectory_.reset ();
+    return;
+  }
+  const QString key = binaryVersion_ + runArguments_.join (QLatin1Char (' ')) +
+                      settings_->customParameters ();
+  buildDirectory_.setKey (projectDirectory_, key);
+}
+
+void CppcheckRunner::checkUnusedFunctions (const QStringList &fileNames) {
+  Q_ASSERT (settings_ != NULL);
+  if (!settings_->checkUnused () || fileNames.isEmpty ()) {
+    return;
+  }
+  unusedLane_.files.clear ();
+  QSet<int> added;
+  // Files out of compilation database can't be checked within it.
+  for (const auto &file: fileNames) {
+    if (compilationDatabase_.isEmpty () || compilationDatabase_.contains (file)) {
+      const int handle = paths_->intern (file);
+      if (!added.contains (handle)) {
+        added.insert (handle);
+        unusedLane_.files << handle;
+      }
+    }
+  }
+  updateCost (unusedLane_);
+  // Started in checkQueuedFiles after project checks.
+}
+
+void CppcheckRunner::checkFiles (const QStringList &fileNames, CheckMode mode) {
   Q_ASSERT (!fileNames.isEmpty ());
-  fileCheckQueue_ += fileNames;
-  fileCheckQueue_.removeDuplicates ();
-  fileCheckQueue_.sort ();
-  if (process_.isOpen ()) {
-    if (fileCheckQueue_ == currentlyCheckingFiles_) {
-      process_.kill ();
-      // Rechecking will be restarted on finish signal.
+  QSet<int> requested;
+  for (const auto &file: fileNames) {
+    requested.insert (paths_->intern (file));
+  }
+  if (mode == InteractiveCheck) {
+    // Results of files being checked now will be outdated so restart them.
+    // Other files of stopped shard are checked first when its lane continues.
+    for (auto worker: workers_) {
+      if (!worker->isRunning () || worker->isCanceled () ||
+          workerLanes_.value (worker) == &unusedLane_) {
+        continue;
+      }
+      // Already committed files are not checked again.
+      const QVector<int> files = paths_->intern (worker->uncheckedFiles ());
+      for (auto file: files) {
+        if (requested.contains (file)) { // Configuration jobs have no rest.
+          Lane *lane = workerLanes_.value (worker);
+          Q_ASSERT (lane != NULL);
+          QVector<int> rest;
+          for (auto i: files) {
+            if (!requested.contains (i)) {
+              rest << i;
+            }
+          }
+          prependFiles (*lane, rest);
+          worker->kill ();
+          break;
+        }
+      }
+    }
+    for (auto it = configJobs_.begin (); it != configJobs_.end ();) {
+      it = requested.contains (paths_->find (it->file)) ? configJobs_.erase (it) : it + 1;
+    }
+    removeFiles (interactiveLane_, requested);
+    removeFiles (projectLane_, requested);
+    if (!cacheArguments_.isEmpty ()) {
+      // Saved files are changed since their states were read.
+      ResultCache *cache = &resultCache_;
+      Utils::runAsync (&cachePool_, [cache] {cache->forgetStates ();});
+    }
+    lookUpFiles (requested.toList ().toVector (), mode);
+  }
+  else{
+    // Continue project scan instead of restarting it.
+    QSet<int> queued;
+    queued.reserve (projectLane_.files.size () + interactiveLane_.files.size ());
+    for (const auto lane: {&projectLane_, &interactiveLane_}) {
+      for (auto file: lane->files) {
+        queued.insert (file);
+      }
+    }
+    for (const auto &job: configJobs_) {
+      queued.insert (paths_->intern (job.file));
+    }
+    for (const auto worker: workers_) {
+      if (worker->isRunning () && !worker->isCanceled () &&
+          workerLanes_.value (worker) != &unusedLane_) {
+        for (const auto &file: worker->files ()) {
+          queued.insert (paths_->intern (file));
+        }
+      }
+    }
+    QVector<int> files;
+    for (const auto &fileName: fileNames) {
+      const int file = paths_->intern (fileName);
+      if (!queued.contains (file) && !pendingLookups_.contains (file)) {
+        files << file;
+        queued.insert (file);
+      }
+    }
+    const int batchSize = !cacheArguments_.isEmpty () ? lookupBatchSize : files.size ();
+    for (int i = 0; i < files.size (); i += batchSize) {
+      lookUpFiles (files.mid (i, batchSize), mode);
+    }
+  }
+}
+
+void CppcheckRunner::queueFiles (const QVector<int> &files, CheckMode mode) {
+  if (mode == InteractiveCheck) {
+    QVector<int> sorted = files;
+    sortByCost (sorted, Qt::AscendingOrder); // Show first results faster.
+    // Could be requeued while looked up.
+    const QSet<int> added = sorted.toList ().toSet ();
+    removeFiles (interactiveLane_, added);
+    removeFiles (projectLane_, added);
+    prependFiles (interactiveLane_, sorted);
+    splitConfigurations (sorted);
+  }
+  else{
+    QVector<int> sorted = files;
+    // Slowest first to not wait for the heaviest file at the end.
+    sortByCost (sorted, Qt::DescendingOrder);
+    // Lane is already sorted, so merge batch into it.
+    QVector<int> merged;
+    merged.reserve (projectLane_.files.size () + sorted.size ());
+    std::merge (projectLane_.files.cbegin (), projectLane_.files.cend (),
+                sorted.cbegin (), sorted.cend (), std::back_inserter (merged),
+                [this] (int l, int r) {return handleCost (l) > handleCost (r);});
+    projectLane_.files = merged;
+    for (auto file: sorted) {
+      projectLane_.cost += handleCost (file);
     }
-    return;
   }
   // Delay helps to avoid double checking same file on editor change.
   const int checkDelayInMs = 200;
@@ -116,15 +374,216 @@ void CppcheckRunner::checkFiles (const QStringList &fileNames) {
   }
 }
 
+void CppcheckRunner::lookUpFiles (const QVector<int> &files, CheckMode mode) {
+  if (cacheArguments_.isEmpty ()) {
+    queueFiles (files, mode);
+    return;
+  }
+  // Newer request of file replaces older one that is still looked up.
+  const int lookup = ++lastLookup_;
+  for (auto file: files) {
+    pendingLookups_.insert (file, {mode, lookup});
+  }
+  auto watcher = new QFutureWatcher<CacheLookup> (this);
+  lookupWatchers_ << watcher;
+  connect (watcher, &QFutureWatcher<CacheLookup>::finished,
+           this, [this, watcher, lookup, mode] {
+    lookupWatchers_.removeOne (watcher);
+    watcher->deleteLater ();
+    if (watcher->future ().resultCount () > 0) {
+      takeLookup (lookup, mode, watcher->result ());
+    }
+  });
+  watcher->setFuture (Utils::runAsync (&cachePool_, &CppcheckRunner::lookUpResults,
+                                       &resultCache_, cacheRequests (files)));
+}
+
+void CppcheckRunner::takeLookup (int lookup, CheckMode mode, const CacheLookup &result) {
+  QVector<int> files;
+  int hitCount = 0;
+  for (const auto &request: result.requests) {
+    const int file = paths_->intern (request.fileName);
+    auto pending = pendingLookups_.find (file);
+    if (pending == pendingLookups_.end () || pending->lookup != lookup) { // Stopped or repeated.
+      continue;
+    }
+    pendingLookups_.erase (pending);
+    auto hit = result.hits.constFind (request.fileName);
+    if (hit != result.hits.constEnd ()) {
+      pendingFiles_ << request.fileName;
+      pendingTasks_ += hit.value ();
+      ++hitCount;
+      continue;
+    }
+    if (!request.key.isEmpty ()) {
+      cacheRequests_.insert (request.fileName, request);
+    }
+    files << file;
+  }
+  if (hitCount > 0) {
+    if (showOutput_) {
+      Core::MessageManager::write (tr ("Cppcheck: %1 unchanged file(s) are not checked again")
+                                   .arg (hitCount), Core::MessageManager::Silent);
+    }
+    if (pendingTasks_.size () >= maxTaskBatchSize) {
+      flushTasks ();
+    }
+    else if (!tasksTimer_.isActive ()) {
+      tasksTimer_.start ();
+    }
+  }
+  if (!files.isEmpty ()) {
+    queueFiles (files, mode);
+  }
+  else if (pendingLookups_.isEmpty ()) {
+    // Whole program check or session end could wait for cached files.
+    checkQueuedFiles ();
+    if (!isRunning ()) {
+      finishProgress ();
+    }
+  }
+}
+
+QList<CppcheckRunner::CacheRequest> CppcheckRunner::cacheRequests (const QVector<int> &files) const {
+  Q_ASSERT (settings_ != NULL);
+  // Everything that is passed to binary for the file.
+  const QString common = cacheArguments_ + QLatin1Char ('\n') +
+                         Utils::globalMacroExpander ()->expand (settings_->customParameters ()) +
+                         QLatin1Char ('\n');
+  const bool withIncludes = !settings_->ignoreIncludePaths ();
+  const QStringList projectIncludes = paths_->paths (includePaths_);
+  // Flags and include paths by group. Database passes same flags for all files of group.
+  QHash<int, QPair<QString, QStringList> > groups;
+  QList<CacheRequest> requests;
+  requests.reserve (files.size ());
+  for (auto handle: files) {
+    CacheRequest request;
+    request.fileName = paths_->path (handle);
+    request.includePaths = projectIncludes;
+    QString flags;
+    const int group = compilationDatabase_.group (request.fileName);
+    if (group != -1) {
+      auto it = groups.find (group);
+      if (it == groups.end ()) {
+        QStringList includes = compilationDatabase_.includes (group);
+        for (auto &include: includes) {
+          include = include.mid (2); // -I
+        }
+        it = groups.insert (group, qMakePair (compilationDatabase_.arguments (group)
+                                              .join (QLatin1Char (' ')), includes));
+      }
+      flags = it->first;
+      request.includePaths = it->second;
+      if (compilationDatabase_.contains (request.fileName)) {
+        flags.prepend (QLatin1String ("database "));
+      }
+    }
+    request.arguments = common + QString::number (costModel_.maxConfigs (request.fileName)) +
+                        QLatin1Char ('\n') + flags + QLatin1Char ('\n') +
+                        (withIncludes ? request.includePaths.join (QLatin1Char (' '))
+                         : QLatin1String ("noIncludes"));
+    requests << request;
+  }
+  return requests;
+}
+
+void CppcheckRunner::lookUpResults (QFutureInterface<CacheLookup> &future, ResultCache *cache,
+                                    QList<CacheRequest> requests) {
+  Q_ASSERT (cache != NULL);
+  CacheLookup result;
+  QList<Diagnostic> diagnostics;
+  for (auto &request: requests) {
+    if (future.isCanceled ()) {
+      return;
+    }
+    request.key = cache->key (request.fileName, request.arguments, request.includePaths);
+    if (!request.key.isEmpty () && cache->find (request.key, diagnostics)) {
+      result.hits.insert (request.fileName, diagnostics);
+    }
+  }
+  result.requests = requests;
+  future.reportResult (result);
+}
+
+void CppcheckRunner::storeResults (ResultCache *cache,
+                                   const QList<QPair<CacheRequest, QList<Diagnostic> > > &entries) {
+  Q_ASSERT (cache != NULL);
+  for (const auto &i: entries) {
+    // File could be changed after lookup and checked with new contents.
+    cache->forgetState (i.first.fileName);
+    if (cache->key (i.first.fileName, i.first.arguments, i.first.includePaths) == i.first.key) {
+      cache->insert (i.first.key, i.second);
+    }
+  }
+}
+
+void CppcheckRunner::maintainCaches (ResultCache *cache, BuildDirectory buildDirectory,
+                                     qint64 sizeLimit) {
+  Q_ASSERT (cache != NULL);
+  // Caches share one limit. Results are small and save more time so go first.
+  cache->limitSize (sizeLimit);
+  cache->save ();
+  if (buildDirectory.isValid ()) {
+    buildDirectory.limitSize (std::max (sizeLimit - cache->size (), qint64 (0)));
+  }
+}
+
+qint64 CppcheckRunner::predictedCost (const QStringList &fileNames) const {
+  qint64 cost = 0;
+  for (const auto &file: fileNames) {
+    cost += costModel_.cost (file);
+  }
+  return cost;
+}
+
+qint64 CppcheckRunner::remainingCost () const {
+  qint64 cost = interactiveLane_.cost + projectLane_.cost + unusedLane_.cost;
+  for (const auto &job: configJobs_) {
+    cost += job.cost;
+  }
+  for (const auto worker: workers_) {
+    if (!worker->isRunning () || worker->isCanceled ()) {
+      continue;
+    }
+    cost += std::max (workerCosts_.value (worker), qint64 (0));
+  }
+  return cost;
+}
+
+qint64 CppcheckRunner::fileCost (const CppcheckWorker *worker, const QString &fileName) const {
+  if (workerLanes_.value (worker) == &configLane_) {
+    return costModel_.cost (fileName) / (costModel_.configurations (fileName).size () + 1);
+  }
+  return costModel_.cost (fileName);
+}
+
 void CppcheckRunner::stopChecking () {
-  fileCheckQueue_.clear ();
-  if (process_.isOpen ()) {
-    process_.kill ();
+  for (auto watcher: lookupWatchers_) {
+    watcher->cancel ();
+  }
+  pendingLookups_.clear ();
+  interactiveLane_ = Lane ();
+  projectLane_ = Lane ();
+  unusedLane_ = Lane ();
+  configJobs_.clear ();
+  for (auto worker: workers_) {
+    worker->kill ();
   }
 }
 
+void CppcheckRunner::clear () {
+  stopChecking ();
+  // Killed workers' results are dropped by them, batch is emitted on their finish.
+  tasksTimer_.stop ();
+  pendingFiles_.clear ();
+  pendingTasks_.clear ();
+  workerTasks_.clear ();
+  splitResults_.clear ();
+}
+
 void CppcheckRunner::checkQueuedFiles () {
-  if (fileCheckQueue_.isEmpty ()) {
+  if (interactiveLane_.files.isEmpty () && projectLane_.files.isEmpty () &&
+      unusedLane_.files.isEmpty () && configJobs_.isEmpty ()) {
     return;
   }
   QString binary = settings_->binaryFile ();
@@ -134,111 +593,536 @@ void CppcheckRunner::checkQueuedFiles () {
   // Pass custom params BEFORE most of runner's to shadow if some repeat.
   auto expander = Utils::globalMacroExpander ();
   auto expanded = expander->expand (settings_->customParameters ());
-  QStringList arguments (expanded.split (QLatin1Char (' '), QString::SkipEmptyParts));
-  arguments += runArguments_;
-
-  auto includes = !settings_->ignoreIncludePaths () ? includePaths_ : QStringList {};
-  currentlyCheckingFiles_ = fileCheckQueue_;
-  fileCheckQueue_.clear ();
-
-  int argumentLength = arguments.join (QLatin1Literal (" ")).length ();
-  int filesLength = currentlyCheckingFiles_.join (QLatin1Literal (" ")).length ();
-  int includesLength = includes.join (QLatin1Literal (" ")).length ();
-  if (argumentLength + includesLength + filesLength >= maxArgumentsLength_) {
-    if (fileListFileContents_ != currentlyCheckingFiles_) {
-      fileListFileContents_ = currentlyCheckingFiles_;
-      fileListFile_.resize (0);
-      includeListFile_.resize (0);
-
-      if (fileListFile_.open () && includeListFile_.open ()) {
-        QByteArray filesArg = fileListFileContents_.join (QLatin1String ("\n")).toLocal8Bit ();
-        fileListFile_.write (filesArg);
-        fileListFile_.close ();
-
-        for (auto &i: includes) {
-          i = i.mid (2);
-        }
-        QByteArray includesArg = includes.join (QLatin1String ("\n")).toLocal8Bit ();
-        includeListFile_.write (includesArg);
-        includeListFile_.close ();
+  QStringList customArguments (expanded.split (QLatin1Char (' '), QString::SkipEmptyParts));
+  // Not zero exit code means failed check, so it must not report found issues.
+  for (auto it = customArguments.begin (); it != customArguments.end ();) {
+    it = it->startsWith (QLatin1String ("--error-exitcode")) ? customArguments.erase (it) : it + 1;
+  }
+  QStringList arguments = customArguments + runArguments_;
+
+  auto includes = !settings_->ignoreIncludePaths () ? includeArguments () : QStringList {};
+
+  // Interactive checks can use any worker, project ones only not reserved.
+  if (!startConfigJobs (binary, arguments, includes) ||
+      !startShards (interactiveLane_, 0, workers_.size (), binary, arguments, includes) ||
+      !startShards (projectLane_, reservedWorkerCount_, projectWorkerCount_,
+                    binary, arguments, includes)) {
+    return;
+  }
+
+  // Whole program check uses results of all files so starts after project check.
+  if (!unusedLane_.files.isEmpty () && projectLane_.files.isEmpty () &&
+      !workerLanes_.values ().contains (&projectLane_)) {
+    QStringList unusedArguments = customArguments + unusedArguments_;
+    // Without build directory cppcheck disables unusedFunction in multithreaded mode.
+    if (buildDirectory_.isValid ()) {
+      unusedArguments << QLatin1String ("-j") << QString::number (projectWorkerCount_);
+    }
+    startShards (unusedLane_, reservedWorkerCount_, 1, binary, unusedArguments, includes);
+  }
+  updateProgress ();
+}
+
+bool CppcheckRunner::startShards (Lane &lane, int firstWorker, int workerCount,
+                                  const QString &binary, const QStringList &arguments,
+                                  const QStringList &includes) {
+  while (!lane.files.isEmpty ()) {
+    CppcheckWorker *worker = idleWorker (firstWorker, workerCount);
+    if (worker == NULL) {
+      break;
+    }
+    int slot = -1;
+    QStringList shard = takeShard (lane, workerCount, slot);
+    if (shard.isEmpty ()) { // Whole program build directory slot is busy.
+      break;
+    }
+    QStringList shardArguments = arguments;
+    if (slot != -1) {
+      shardArguments << QLatin1String ("--cppcheck-build-dir=") + buildDirectory_.path (slot);
+    }
+    const int maxConfigs = (&lane != &unusedLane_) ? costModel_.maxConfigs (shard.first ()) : 0;
+    if (maxConfigs > 0) {
+      shardArguments << QString (QLatin1String ("--max-configs=%1")).arg (maxConfigs);
+    }
+    startProgress ();
+    workerTasks_.remove (worker);
+    if (maxConfigs > 0) { // Reported with other results of file.
+      Diagnostic diagnostic;
+      diagnostic.severity = QLatin1String ("information");
+      diagnostic.message = tr ("Checked only %1 configuration(s) because checking "
+                               "all of them is too slow").arg (maxConfigs);
+      diagnostic.locations.resize (1);
+      auto &tasks = workerTasks_[worker];
+      for (const auto &file: shard) {
+        diagnostic.locations.first ().file = file;
+        diagnostic.checkedFile = file;
+        tasks[file].append (diagnostic);
       }
-      else{
-        Core::MessageManager::write (tr ("Failed to write cppcheck's argument files"),
-                                     Core::MessageManager::Silent);
-        return;
+    }
+    workerLanes_.insert (worker, &lane);
+    workerSlots_.insert (worker, slot);
+    qint64 shardCost = 0;
+    for (const auto &file: shard) {
+      shardCost += costModel_.cost (file);
+    }
+    workerCosts_.insert (worker, shardCost);
+    // Shard's files share flag group so use its flags instead of common ones.
+    QByteArray projectJson;
+    QStringList shardIncludes = includes;
+    const int group = compilationDatabase_.group (shard.first ());
+    if (compilationDatabase_.contains (shard.first ())) {
+      projectJson = compilationDatabase_.json (shard, !settings_->ignoreIncludePaths ());
+    }
+    else if (group != -1) {
+      shardArguments += compilationDatabase_.arguments (group);
+      shardIncludes = !settings_->ignoreIncludePaths () ? compilationDatabase_.includes (group)
+                      : QStringList {};
+    }
+    if (!worker->start (binary, shardArguments, shardIncludes, shard, projectJson,
+                        maxArgumentsLength_)) { // Others will fail too.
+      abortStart (worker);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CppcheckRunner::startConfigJobs (const QString &binary, const QStringList &arguments,
+                                      const QStringList &includes) {
+  while (!configJobs_.isEmpty ()) {
+    CppcheckWorker *worker = idleWorker (0, workers_.size ());
+    if (worker == NULL) {
+      break;
+    }
+    const ConfigJob job = configJobs_.takeFirst ();
+    startProgress ();
+    workerTasks_.remove (worker);
+    // Analyzer info of configuration would overwrite full one.
+    workerLanes_.insert (worker, &configLane_);
+    workerSlots_.insert (worker, -1);
+    workerCosts_.insert (worker, job.cost);
+    if (!worker->start (binary, arguments + job.arguments, includes, QStringList {job.file},
+                        QByteArray (), maxArgumentsLength_)) { // Others will fail too.
+      abortStart (worker);
+      return false;
+    }
+  }
+  return true;
+}
+
+void CppcheckRunner::abortStart (CppcheckWorker *worker) {
+  Q_ASSERT (worker != NULL);
+  workerLanes_.remove (worker);
+  workerSlots_.remove (worker);
+  workerCosts_.remove (worker);
+  workerTasks_.remove (worker);
+  // Taken shard is dropped with all queued files.
+  stopChecking ();
+  if (!isRunning ()) { // Finish of others ends progress otherwise.
+    finishProgress ();
+  }
+}
+
+void CppcheckRunner::splitConfigurations (const QVector<int> &files) {
+  QSet<int> splitFiles;
+  for (auto handle: files) {
+    const QString file = paths_->path (handle);
+    // Limited or pinned configurations are not split.
+    const QStringList configurations = costModel_.configurations (file);
+    if (configurations.size () < minSplitConfigurations ||
+        costModel_.cost (file) < minSplitCostMs || costModel_.maxConfigs (file) > 0 ||
+        compilationDatabase_.group (file) != -1) {
+      continue;
+    }
+    splitFiles.insert (handle);
+    SplitResult &result = splitResults_[file];
+    result = SplitResult ();
+    result.jobsLeft = configurations.size () + 1;
+    result.cacheRequest = cacheRequests_.take (file);
+    const qint64 jobCost = costModel_.cost (file) / (configurations.size () + 1);
+    // Default configuration is always the first one.
+    configJobs_.append ({file, {QLatin1String ("--max-configs=1")}, jobCost});
+    for (const auto &configuration: configurations) {
+      ConfigJob job {file, {}, jobCost};
+      for (const auto &define: configuration.split (QLatin1Char (';'), QString::SkipEmptyParts)) {
+        job.arguments << QLatin1String ("-D") + define;
+      }
+      configJobs_.append (job);
+    }
+  }
+  removeFiles (interactiveLane_, splitFiles);
+}
+
+void CppcheckRunner::addTasks (CppcheckWorker *worker, const QList<Diagnostic> &diagnostics) {
+  Q_ASSERT (worker != NULL);
+  if (workerLanes_.value (worker) == &unusedLane_) {
+    // Replace previous whole program results at once when pass is done.
+    // Other findings are reported by checks of files.
+    const QString unit = QLatin1String (Constants::WHOLE_PROGRAM_UNIT);
+    auto &tasks = workerTasks_[worker][unit];
+    for (const auto &diagnostic: diagnostics) {
+      if (diagnostic.id == QLatin1String ("unusedFunction")) {
+        tasks.append (diagnostic);
+        tasks.last ().checkedFile = unit;
       }
     }
-    arguments << QString (QLatin1String ("--file-list=%1")).arg (fileListFile_.fileName ());
-    arguments << QString (QLatin1String ("--includes-file=%1")).arg (includeListFile_.fileName ());
   }
   else{
-    arguments += currentlyCheckingFiles_;
-    arguments += includes;
+    // Keep until checked file is done to replace its previous results at once.
+    auto &tasks = workerTasks_[worker];
+    const QStringList &files = worker->files ();
+    for (const auto &diagnostic: diagnostics) {
+      const QString &file = files.contains (diagnostic.checkedFile) ? diagnostic.checkedFile
+                            : !worker->currentFile ().isEmpty () ? worker->currentFile ()
+                            : files.first ();
+      tasks[file].append (diagnostic);
+    }
   }
-  emit startedChecking (currentlyCheckingFiles_);
-  if (showOutput_) {
-    Core::MessageManager::write (QString ("Starting CppChecker with:%1, %2")
-                                 .arg (binary,arguments.join (" ")), Core::MessageManager::WithFocus);
+  if (pendingTasks_.size () >= maxTaskBatchSize) {
+    flushTasks ();
+  }
+  else if (!pendingTasks_.isEmpty () && !tasksTimer_.isActive ()) {
+    tasksTimer_.start ();
   }
-  process_.start (binary, arguments);
 }
 
-void CppcheckRunner::readOutput () {
-  if (!showOutput_) {
+void CppcheckRunner::commitFile (CppcheckWorker *worker, const QString &fileName) {
+  Q_ASSERT (worker != NULL);
+  pendingFiles_ << fileName;
+  QList<Diagnostic> diagnostics;
+  auto tasks = workerTasks_.find (worker);
+  if (tasks != workerTasks_.end ()) {
+    diagnostics = tasks->take (fileName);
+  }
+  // Cached when process exit status is known.
+  const CacheRequest request = cacheRequests_.take (fileName);
+  if (!request.key.isEmpty ()) {
+    workerCacheEntries_[worker].append (qMakePair (request, diagnostics));
+  }
+  pendingTasks_ += diagnostics;
+  if (pendingTasks_.size () >= maxTaskBatchSize) {
+    flushTasks ();
+  }
+  else if (!tasksTimer_.isActive ()) {
+    tasksTimer_.start ();
+  }
+}
+
+void CppcheckRunner::requeueCrashedFiles (CppcheckWorker *worker, Lane &lane) {
+  Q_ASSERT (worker != NULL);
+  // Not finished files keep previous tasks (and cached results).
+  QStringList files = worker->uncheckedFiles ();
+  auto tasks = workerTasks_.find (worker);
+  for (const auto &file: files) {
+    if (tasks != workerTasks_.end ()) {
+      tasks->remove (file);
+    }
+    cacheRequests_.remove (file);
+  }
+  // Late results of already done files.
+  if (tasks != workerTasks_.end ()) {
+    for (const auto &diagnostics: tasks.value ()) {
+      pendingTasks_ += diagnostics;
+    }
+  }
+  // File that crashed process is not checked again. Others are rechecked only if
+  // process has done something, so restarts always make progress and process that
+  // fails at start (e.g. because of wrong arguments) is not restarted forever.
+  const QString &crashedFile = worker->currentFile ();
+  const bool hasProgress = !crashedFile.isEmpty () || files.size () < worker->files ().size ();
+  if (!crashedFile.isEmpty ()) {
+    files.removeOne (crashedFile);
+    Core::MessageManager::write (tr ("Cppcheck: checking of %1 failed, its previous results "
+                                     "are kept").arg (crashedFile), Core::MessageManager::Silent);
+  }
+  else{
+    Core::MessageManager::write (tr ("Cppcheck: checking of %1 file(s) failed, their previous "
+                                     "results are kept").arg (files.size ()),
+                                 Core::MessageManager::Silent);
+  }
+  if (hasProgress && !files.isEmpty ()) {
+    prependFiles (lane, paths_->intern (files));
+  }
+}
+
+void CppcheckRunner::commitConfigJob (CppcheckWorker *worker) {
+  Q_ASSERT (worker != NULL);
+  const QString &file = worker->files ().first ();
+  auto result = splitResults_.find (file);
+  if (result == splitResults_.end ()) { // Split was restarted.
+    return;
+  }
+  if (worker->hasCrashed ()) { // Merged results would miss findings of configuration.
+    result->hasFailed = true;
+    workerTasks_.remove (worker);
+  }
+  // Configurations share most of code so same issues are found by several jobs.
+  for (const auto &diagnostics: workerTasks_.take (worker)) {
+    for (const auto &diagnostic: diagnostics) {
+      const QString key = diagnostic.file () + QLatin1Char ('\n') +
+                          QString::number (diagnostic.line ()) + QLatin1Char ('\n') +
+                          diagnostic.id + QLatin1Char ('\n') + diagnostic.message;
+      if (!result->keys.contains (key)) {
+        result->keys.insert (key);
+        result->diagnostics.append (diagnostic);
+      }
+    }
+  }
+  if (--result->jobsLeft > 0) {
     return;
   }
-  process_.setReadChannel (QProcess::StandardOutput);
+  if (result->hasFailed) {
+    Core::MessageManager::write (tr ("Cppcheck: checking of %1 failed, its previous results "
+                                     "are kept").arg (file), Core::MessageManager::Silent);
+    splitResults_.erase (result);
+    return;
+  }
+  pendingFiles_ << file;
+  pendingTasks_ += result->diagnostics;
+  if (!result->cacheRequest.key.isEmpty ()) {
+    const QList<QPair<CacheRequest, QList<Diagnostic> > > entries {
+      qMakePair (result->cacheRequest, result->diagnostics)
+    };
+    Utils::runAsync (&cachePool_, &CppcheckRunner::storeResults, &resultCache_, entries);
+  }
+  splitResults_.erase (result);
+  if (!tasksTimer_.isActive ()) {
+    tasksTimer_.start ();
+  }
+}
+
+void CppcheckRunner::flushTasks () {
+  tasksTimer_.stop ();
+  if (pendingFiles_.isEmpty () && pendingTasks_.isEmpty ()) {
+    return;
+  }
+  QStringList files;
+  files.swap (pendingFiles_);
+  QList<Diagnostic> diagnostics;
+  diagnostics.swap (pendingTasks_);
+  emit filesChecked (files, diagnostics);
+}
+
+QStringList CppcheckRunner::takeShard (Lane &lane, int workerCount, int &slot) {
+  const bool isIncremental = buildDirectory_.isValid ();
+  QSet<int> busySlots;
+  for (auto i: workerSlots_) {
+    if (i != -1) {
+      busySlots.insert (i);
+    }
+  }
+  // Whole program check needs all files in one run.
+  const bool isWholeLane = (&lane == &unusedLane_);
+  if (isWholeLane && isIncremental && busySlots.contains (BuildDirectory::wholeProgramSlot)) {
+    return {};
+  }
 
-  while (!process_.atEnd () && process_.canReadLine ()) {
-    QByteArray rawLine = process_.readLine ();
-    QString line = QString::fromUtf8 (rawLine).trimmed ();
-    if (line.isEmpty ()) {
+  // Guided scheduling: big shards at start to reduce process launches,
+  // small ones at the end to keep all workers busy until the last file.
+  // Shard takes files of single not used build directory slot
+  // that are checked same way (with compilation database or without)
+  // and with same flags and configurations limit. Whole program check needs
+  // all files in one run, database passes flags of each file so group
+  // is not required then.
+  const int maxShardSize = isWholeLane ? lane.files.size () : 32;
+  const qint64 targetCost = lane.cost / (workerCount * 2);
+  qint64 shardCost = 0;
+  QVector<int> shard;
+  QVector<int> rest;
+  rest.reserve (lane.files.size ());
+  slot = -1;
+  bool hasGroup = false;
+  bool isInDatabase = false;
+  int group = -1;
+  int maxConfigs = 0;
+  for (int i = 0, end = lane.files.size (); i < end; ++i) {
+    if (shard.size () >= maxShardSize ||
+        (!isWholeLane && !shard.isEmpty () && shardCost >= targetCost)) {
+      rest += lane.files.mid (i);
+      break;
+    }
+    const int file = lane.files.at (i);
+    const FileInfo info = fileInfo (file);
+    const int fileSlot = !isIncremental ? -1 : isWholeLane ? int (BuildDirectory::wholeProgramSlot)
+                         : info.slot;
+    const bool fileInDatabase = info.isInDatabase;
+    const int fileGroup = (isWholeLane && fileInDatabase) ? -1 : info.group;
+    const int fileMaxConfigs = isWholeLane ? 0 : info.maxConfigs;
+    if (!hasGroup && !busySlots.contains (fileSlot)) {
+      slot = fileSlot;
+      isInDatabase = fileInDatabase;
+      group = fileGroup;
+      maxConfigs = fileMaxConfigs;
+      hasGroup = true;
+    }
+    if (!hasGroup || fileSlot != slot || fileInDatabase != isInDatabase ||
+        fileGroup != group || fileMaxConfigs != maxConfigs) {
+      rest << file;
       continue;
     }
-    const QString progressSample = QLatin1String ("% done");
-    // check futureInterface because read can be triggered before started..
-    if (line.endsWith (progressSample) && futureInterface_ != NULL) {
-      int percentEndIndex = line.length () - progressSample.length ();
-      int percentStartIndex = line.lastIndexOf (QLatin1String (" "), percentEndIndex);
-      int done = line.mid (percentStartIndex, percentEndIndex - percentStartIndex).toInt ();
-      futureInterface_->setProgressValue (done);
+    shardCost += handleCost (file);
+    shard << file;
+  }
+  lane.files = rest;
+  if (shard.isEmpty () && !lane.files.isEmpty ()) {
+    // Slots of all queued files are busy. Do not wait, check without analyzer info.
+    slot = -1;
+    shard << lane.files.takeFirst ();
+    shardCost += handleCost (shard.first ());
+  }
+  lane.cost = std::max (lane.cost - shardCost, qint64 (0));
+  return paths_->paths (shard);
+}
+
+void CppcheckRunner::prependFiles (Lane &lane, const QVector<int> &files) {
+  for (auto file: files) {
+    lane.cost += handleCost (file);
+  }
+  lane.files = files + lane.files;
+}
+
+void CppcheckRunner::removeFiles (Lane &lane, const QSet<int> &files) {
+  for (auto it = lane.files.begin (); it != lane.files.end ();) {
+    if (files.contains (*it)) {
+      lane.cost -= handleCost (*it);
+      it = lane.files.erase (it);
+    }
+    else{
+      ++it;
     }
-    Core::MessageManager::write (line, Core::MessageManager::Silent);
   }
+  lane.cost = std::max (lane.cost, qint64 (0));
 }
 
-void CppcheckRunner::readError () {
-  process_.setReadChannel (QProcess::StandardError);
+void CppcheckRunner::updateCost (Lane &lane) {
+  lane.cost = 0;
+  for (auto file: lane.files) {
+    lane.cost += handleCost (file);
+  }
+}
 
-  while (!process_.atEnd () && process_.canReadLine ()) {
-    QByteArray rawLine = process_.readLine ();
-    QString line = QString::fromUtf8 (rawLine).trimmed ();
-    if (line.isEmpty ()) {
-      continue;
+CppcheckRunner::FileInfo CppcheckRunner::fileInfo (int handle) const {
+  Q_ASSERT (handle >= 0 && handle < paths_->size ());
+  if (handle >= fileInfos_.size ()) {
+    fileInfos_.resize (paths_->size ());
+  }
+  FileInfo &info = fileInfos_[handle];
+  if (!info.isValid) {
+    const QString file = paths_->path (handle);
+    info.cost = costModel_.measuredCost (file);
+    info.slot = BuildDirectory::slot (file);
+    info.maxConfigs = costModel_.maxConfigs (file);
+    info.group = compilationDatabase_.group (file);
+    info.isInDatabase = compilationDatabase_.contains (file);
+    info.isValid = true;
+  }
+  return info;
+}
+
+qint64 CppcheckRunner::handleCost (int handle) const {
+  const int cost = fileInfo (handle).cost;
+  return (cost != -1) ? cost : costModel_.averageCost ();
+}
+
+void CppcheckRunner::invalidateFileInfo (const QString &fileName) {
+  const int handle = paths_->find (fileName);
+  if (handle != -1 && handle < fileInfos_.size ()) {
+    fileInfos_[handle].isValid = false;
+  }
+}
+
+void CppcheckRunner::sortByCost (QVector<int> &files, Qt::SortOrder order) const {
+  QVector<QPair<qint64, int> > costs;
+  costs.reserve (files.size ());
+  for (auto file: files) {
+    costs.append (qMakePair (handleCost (file), file));
+  }
+  if (order == Qt::AscendingOrder) {
+    std::sort (costs.begin (), costs.end ());
+  }
+  else{
+    std::sort (costs.rbegin (), costs.rend ());
+  }
+  files.clear ();
+  for (const auto &i: costs) {
+    files << i.second;
+  }
+}
+
+CppcheckWorker *CppcheckRunner::idleWorker (int first, int count) const {
+  for (int i = first, end = std::min (first + count, workers_.size ()); i < end; ++i) {
+    if (!workers_[i]->isRunning ()) {
+      return workers_[i];
     }
-    if (showOutput_) {
-      Core::MessageManager::write (line, Core::MessageManager::Silent);
+  }
+  return NULL;
+}
+
+bool CppcheckRunner::isRunning () const {
+  for (const auto worker: workers_) {
+    if (worker->isRunning ()) {
+      return true;
     }
-    QStringList details = line.split (QLatin1Char (','));
-    if (details.size () <= ErrorFieldMessage) {
-      continue;
+  }
+  return false;
+}
+
+void CppcheckRunner::workerFinished (CppcheckWorker *worker) {
+  Q_ASSERT (worker != NULL);
+  Lane *lane = workerLanes_.take (worker);
+  workerSlots_.remove (worker);
+  workerCosts_.remove (worker);
+  // Crashed process could write wrong results even for done files.
+  const auto cacheEntries = workerCacheEntries_.take (worker);
+  if (!worker->hasCrashed () && !cacheEntries.isEmpty ()) {
+    Utils::runAsync (&cachePool_, &CppcheckRunner::storeResults, &resultCache_, cacheEntries);
+  }
+  if (!worker->isCanceled ()) {
+    if (lane == &configLane_) {
+      commitConfigJob (worker);
     }
-    QString file = QDir::fromNativeSeparators (details.at (ErrorFieldFile));
-    int lineNumber = details.at (ErrorFieldLine).toInt ();
-    char type = details.at (ErrorFieldSeverity).at (0).toLatin1 ();
-    QString id = "";
-    if (showId_) {
-      id = details.at (ErrorFieldId);
+    else if (lane == &unusedLane_ && worker->hasCrashed ()) {
+      Core::MessageManager::write (tr ("Cppcheck: search of unused functions failed, "
+                                       "previous results are kept"),
+                                   Core::MessageManager::Silent);
     }
-    QString description = line.mid (line.indexOf (details.at (ErrorFieldMessage)));
-    emit newTask (type, id, description, file, lineNumber);
+    else if (lane == &unusedLane_) {
+      commitFile (worker, QLatin1String (Constants::WHOLE_PROGRAM_UNIT));
+    }
+    else if (worker->hasCrashed ()) {
+      Q_ASSERT (lane != NULL);
+      requeueCrashedFiles (worker, *lane);
+    }
+    else{
+      // Files without progress output (single or skipped ones).
+      for (const auto &file: worker->uncheckedFiles ()) {
+        commitFile (worker, file);
+      }
+      // Late results of already done files.
+      for (const auto &diagnostics: workerTasks_.value (worker)) {
+        pendingTasks_ += diagnostics;
+      }
+    }
+  }
+  workerTasks_.remove (worker); // Killed worker's files are checked again.
+  if (worker->hasFailed ()) { // Others will fail too.
+    stopChecking ();
+  }
+  // Lanes are empty if checking was stopped.
+  checkQueuedFiles ();
+  if (isRunning ()) {
+    updateProgress ();
+  }
+  else{
+    finishProgress ();
   }
 }
 
-void CppcheckRunner::started () {
-  if (showOutput_) {
-    Core::MessageManager::write (tr ("Cppcheck started"), Core::MessageManager::Silent);
+void CppcheckRunner::startProgress () {
+  if (futureInterface_ != NULL && futureInterface_->isRunning ()) {
+    return;
   }
+  progressTracker_.start ();
 
   using namespace Core;
   delete futureInterface_;
@@ -248,25 +1132,79 @@ void CppcheckRunner::started () {
   connect (progress, &Core::FutureProgress::canceled, this, &CppcheckRunner::stopChecking);
   futureInterface_->setProgressRange (0, 100); // %
   futureInterface_->reportStarted ();
+  slowFilesTimer_.start ();
 }
 
-void CppcheckRunner::error (QProcess::ProcessError error) {
-  Q_UNUSED (error);
-  if (showOutput_) {
-    Core::MessageManager::write (tr ("Cppcheck error occured"), Core::MessageManager::Silent);
-  }
-  if (error == QProcess::FailedToStart) {
-    finished (-1);
+void CppcheckRunner::updateProgress () {
+  if (futureInterface_ == NULL || !futureInterface_->isRunning ()) {
+    return;
   }
+  const qint64 cost = remainingCost ();
+  const qint64 duration = progressTracker_.remainingTime (cost, projectWorkerCount_);
+  futureInterface_->setProgressValueAndText (progressTracker_.percent (cost),
+                                             tr ("%1 left").arg (durationText (duration)));
 }
 
-void CppcheckRunner::finished (int exitCode) {
-  Q_UNUSED (exitCode);
-  if (futureInterface_ != NULL) {
+void CppcheckRunner::finishProgress () {
+  if (futureInterface_ != NULL && futureInterface_->isRunning ()) {
     futureInterface_->reportFinished ();
   }
-  process_.close ();
-  if (showOutput_) {
-    Core::MessageManager::write (tr ("Cppcheck finished"), Core::MessageManager::Silent);
+  slowFilesTimer_.stop ();
+  flushTasks ();
+  splitResults_.clear ();
+  costModel_.save ();
+  if (!pendingLookups_.isEmpty ()) { // Session continues after lookups.
+    return;
+  }
+  cacheRequests_.clear ();
+  // Files could be changed before next session.
+  ResultCache *cache = &resultCache_;
+  Utils::runAsync (&cachePool_, [cache] {cache->forgetStates ();});
+  // Directories walk is slow so it is not repeated after each short check.
+  if (cacheMaintenanceTimer_.isValid () &&
+      cacheMaintenanceTimer_.elapsed () < cacheMaintenanceIntervalMs) {
+    return;
+  }
+  cacheMaintenanceTimer_.start ();
+  const qint64 cacheSizeLimit = qint64 (settings_->cacheSizeLimit ()) * 1024 * 1024;
+  Utils::runAsync (&cachePool_, &CppcheckRunner::maintainCaches, &resultCache_,
+                   buildDirectory_, cacheSizeLimit);
+}
+
+void CppcheckRunner::checkSlowFiles () {
+  for (auto worker: workers_) {
+    Lane *lane = workerLanes_.value (worker);
+    if (!worker->isRunning () || worker->isCanceled () ||
+        lane == &unusedLane_ || lane == &configLane_) {
+      continue;
+    }
+    // Only not default configurations are reported. Without them there is
+    // nothing to reduce. Files with flags of group (from database or not) have
+    // single pinned configuration though cppcheck reports it.
+    const QString file = worker->currentFile ();
+    if (file.isEmpty () || worker->currentFileElapsed () < slowFileMs ||
+        worker->currentConfigCount () == 0 || compilationDatabase_.group (file) != -1) {
+      continue;
+    }
+    const int maxConfigs = costModel_.maxConfigs (file);
+    int nextMaxConfigs = 0;
+    for (auto i: maxConfigsSteps) {
+      if (maxConfigs == 0 || i < maxConfigs) {
+        nextMaxConfigs = i;
+        break;
+      }
+    }
+    if (nextMaxConfigs == 0) {
+      continue;
+    }
+    costModel_.setMaxConfigs (file, nextMaxConfigs);
+    invalidateFileInfo (file);
+    Core::MessageManager::write (tr ("Cppcheck: %1 is too slow to check all configurations, "
+                                     "checking only %2 of them").arg (file).arg (nextMaxConfigs),
+                                 Core::MessageManager::Silent);
+    Q_ASSERT (lane != NULL);
+    cacheRequests_.remove (file); // Key depends on configurations limit.
+    prependFiles (*lane, paths_->intern (worker->uncheckedFiles ()));
+    worker->kill ();
   }
 }
@@ -1,88 +1,329 @@
 #ifndef CPPCHECKRUNNER_H
 #define CPPCHECKRUNNER_H
 
-#include <QProcess>
 #include <QTimer>
-#include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QVector>
 
 #include <QFuture>
+#include <QFutureWatcher>
+
+#include "CostModel.h"
+#include "BuildDirectory.h"
+#include "CompilationDatabase.h"
+#include "Diagnostic.h"
+#include "ProgressTracker.h"
+#include "ResultCache.h"
+
+namespace CppTools {
+  class ProjectInfo;
+}
 
 namespace QtcCppcheck {
   namespace Internal {
 
     class Settings;
+    class PathTable;
+    class CppcheckWorker;
 
     /*!
      * \brief Cppcheck binary runner.
-     *  Does not have ownership on settings_ (must be destroyed before settings).
-     * Launches, finishes, reads result, passes start arguments, etc.
+     *  Does not have ownership on settings_ and paths_ (must be destroyed before them).
+     * Splits check queue into shards and passes them to pool of workers.
+     * Each idle worker takes next shard so all cores are busy until queue end.
+     * Interactive checks have own lane and reserved workers so they are never
+     * waiting for project scan.
+     * Files are looked up in result cache in background before queueing.
      */
     class CppcheckRunner : public QObject {
       Q_OBJECT
 
       public:
-        explicit CppcheckRunner (Settings *settings, QObject *parent = 0);
+        //! Check reason. Defines queue order.
+        enum CheckMode {
+          //! User waits for result (save, current document). Fastest files first.
+          InteractiveCheck,
+          //! Whole project scan. Slowest files first to not wait for them at the end.
+          ProjectCheck
+        };
+
+        //! Queued files are kept as handles of shared paths table.
+        CppcheckRunner (Settings *settings, PathTable *paths, QObject *parent = 0);
         ~CppcheckRunner ();
 
         //! Add files to check queue.
-        void checkFiles (const QStringList &fileNames);
+        void checkFiles (const QStringList &fileNames, CheckMode mode);
+        //! Search unused functions in given files after project check (if enabled in settings).
+        void checkUnusedFunctions (const QStringList &fileNames);
 
         //! Update data based on current settings_.
         void updateSettings ();
 
         void setIncludePaths (const QStringList &paths);
+        //! Set directory of checking project. Used to keep its analyzer info.
+        void setProjectDirectory (const QString &directory);
+        //! Update compilation database and flag groups from project's code model info.
+        void setProjectInfo (const CppTools::ProjectInfo &info, const QString &projectDirectory);
+
+        //! Predicted time (ms) to check given files (as if in one process).
+        qint64 predictedCost (const QStringList &fileNames) const;
 
       public slots:
         //! Stop check progress if running and clear check queue.
         void stopChecking ();
+        //! Stop checking and drop not emitted results (e.g. of previous project).
+        void clear ();
 
       signals:
-        //! New task has been generated.
-        void newTask (char type, const QString &id, const QString &description,
-                      const QString &fileName, int line);
-        //! Inform about starting checking specified files.
-        void startedChecking (const QStringList &files);
+        //! Files have been checked. Their tasks should be replaced with found ones.
+        //! Whole program check is reported as Constants::WHOLE_PROGRAM_UNIT file.
+        //! Diagnostics of not checked files (e.g. late ones) are added.
+        void filesChecked (const QStringList &files, const QList<Diagnostic> &diagnostics);
 
       private slots:
         //! Check files from queue.
         void checkQueuedFiles ();
 
-        // QProcess handling.
-        void readOutput ();
-        void readError ();
-        void started ();
-        void error (QProcess::ProcessError error);
-        void finished (int exitCode);
+        //! Update progress based on checked files.
+        void updateProgress ();
+        //! Restart files with too many slow configurations in degraded mode.
+        void checkSlowFiles ();
+
+      private:
+        //! Queue of files with same priority.
+        struct Lane {
+          Lane () : cost (0) {}
+          //! Handles of queued files.
+          QVector<int> files;
+          //! Predicted check time of files.
+          qint64 cost;
+        };
+
+        //! Inputs of file's results key in result cache.
+        struct CacheRequest {
+          QString fileName;
+          //! Everything else that affects results (binary, flags, includes).
+          QString arguments;
+          //! Paths to find included files.
+          QStringList includePaths;
+          //! Key at lookup time. Empty if file can't be read.
+          QByteArray key;
+        };
+        //! Result of cache lookup.
+        struct CacheLookup {
+          //! Requests with keys.
+          QList<CacheRequest> requests;
+          //! Cached results of unchanged files.
+          QHash<QString, QList<Diagnostic> > hits;
+        };
+        //! File waiting for cache lookup.
+        struct PendingLookup {
+          CheckMode mode;
+          //! Lookup that must be applied to file (latest one).
+          int lookup;
+        };
+
+        //! Scheduling data of queued file. Cached by handle to not resolve its path.
+        struct FileInfo {
+          FileInfo () : cost (-1), slot (-1), maxConfigs (0), group (-1),
+            isInDatabase (false), isValid (false) {}
+          //! Measured check time or -1 (average one is used then).
+          int cost;
+          //! Build directory slot.
+          int slot;
+          int maxConfigs;
+          //! Flag group of compilation database.
+          int group;
+          bool isInDatabase;
+          bool isValid;
+        };
+
+        //! Check of single file's configuration.
+        struct ConfigJob {
+          QString file;
+          //! Arguments that select configuration.
+          QStringList arguments;
+          //! Predicted check time.
+          qint64 cost;
+        };
+        //! Merged results of file's configuration jobs.
+        struct SplitResult {
+          SplitResult () : jobsLeft (0), hasFailed (false) {}
+          //! Not finished jobs.
+          int jobsLeft;
+          //! Some job crashed so results are incomplete.
+          bool hasFailed;
+          //! Keys of diagnostics to skip repeats.
+          QSet<QString> keys;
+          QList<Diagnostic> diagnostics;
+          //! Key of file's results in result cache.
+          CacheRequest cacheRequest;
+        };
+
+        //! Count finished shard and pass next one to idle worker.
+        void workerFinished (CppcheckWorker *worker);
+        //! Pass lane's shards to idle workers in given range. Returns false on start error.
+        bool startShards (Lane &lane, int firstWorker, int workerCount, const QString &binary,
+                          const QStringList &arguments, const QStringList &includes);
+        //! Pass configuration jobs to idle workers. Returns false on start error.
+        bool startConfigJobs (const QString &binary, const QStringList &arguments,
+                              const QStringList &includes);
+        //! Forget worker that failed to start its shard and stop checking.
+        void abortStart (CppcheckWorker *worker);
+        //! Replace heavy interactive files with many configurations by configuration jobs.
+        void splitConfigurations (const QVector<int> &files);
+        //! Keep worker's tasks until their checked file is done.
+        void addTasks (CppcheckWorker *worker, const QList<Diagnostic> &diagnostics);
+        //! Queue results of worker's checked file to emit.
+        void commitFile (CppcheckWorker *worker, const QString &fileName);
+        //! Merge results of configuration job. Queues them to emit after last job of file.
+        void commitConfigJob (CppcheckWorker *worker);
+        //! Keep previous results of crashed worker's not checked files.
+        //! Files that process did not reach are returned to lane.
+        void requeueCrashedFiles (CppcheckWorker *worker, Lane &lane);
+        //! Emit queued results.
+        void flushTasks ();
+        //! Add files to lanes of given mode.
+        void queueFiles (const QVector<int> &files, CheckMode mode);
+        //! Look up files in result cache in background. Not cached ones are queued.
+        void lookUpFiles (const QVector<int> &files, CheckMode mode);
+        //! Queue cached results of unchanged files and queue others to check.
+        void takeLookup (int lookup, CheckMode mode, const CacheLookup &result);
+        //! Key inputs of given files. Cheap, only hashes are done in background.
+        QList<CacheRequest> cacheRequests (const QVector<int> &files) const;
+        //! Calculate keys and find results (runs in cache thread).
+        static void lookUpResults (QFutureInterface<CacheLookup> &future, ResultCache *cache,
+                                   QList<CacheRequest> requests);
+        //! Cache results of files that are not changed since lookup (runs in cache thread).
+        static void storeResults (ResultCache *cache,
+                                  const QList<QPair<CacheRequest, QList<Diagnostic> > > &entries);
+        //! Limit summary size of caches and save index (runs in cache thread).
+        static void maintainCaches (ResultCache *cache, BuildDirectory buildDirectory,
+                                    qint64 sizeLimit);
+        //! Arguments of includePaths_.
+        QStringList includeArguments () const;
+        //! Take next shard from lane. Shards become smaller at lane end.
+        //! Sets build directory slot of shard or -1 if not used.
+        QStringList takeShard (Lane &lane, int workerCount, int &slot);
+        //! Update build directory based on project, arguments and binary version.
+        void updateBuildDirectory ();
+        //! Add files to lane's front.
+        void prependFiles (Lane &lane, const QVector<int> &files);
+        //! Remove given files from lane.
+        void removeFiles (Lane &lane, const QSet<int> &files);
+        //! Predicted check time of worker's file (part of it for configuration job).
+        qint64 fileCost (const CppcheckWorker *worker, const QString &fileName) const;
+        //! Predicted check time of not checked files (as if in one process).
+        qint64 remainingCost () const;
+        //! Recalculate predicted check time of lane.
+        void updateCost (Lane &lane);
+        //! Scheduling data of file (computed on first use after change).
+        FileInfo fileInfo (int handle) const;
+        //! Predicted check time of file.
+        qint64 handleCost (int handle) const;
+        //! Recompute file's scheduling data on next use (e.g. after measure).
+        void invalidateFileInfo (const QString &fileName);
+        //! Sort files by predicted check time.
+        void sortByCost (QVector<int> &files, Qt::SortOrder order) const;
+        //! Get not running worker in given range.
+        CppcheckWorker *idleWorker (int first, int count) const;
+        bool isRunning () const;
+        //! Create progress task if not exists.
+        void startProgress ();
+        void finishProgress ();
 
       private:
         //! Timer to delay queue checking.
         QTimer queueTimer_;
-        //! Binary runner.
-        QProcess process_;
+        //! Thread of workers' processes.
+        QThread ioThread_;
+        //! Timer to collect tasks before emitting.
+        QTimer tasksTimer_;
+        //! Checked files to emit with next batch.
+        QStringList pendingFiles_;
+        //! Tasks to emit with next batch.
+        QList<Diagnostic> pendingTasks_;
+        //! Tasks of running workers by checked files that are not done yet.
+        QHash<const CppcheckWorker *, QHash<QString, QList<Diagnostic> > > workerTasks_;
+        //! Timer to look for slow files while checking.
+        QTimer slowFilesTimer_;
+        //! Binary runners pool. First reservedWorkerCount_ are used only for interactive checks.
+        QList<CppcheckWorker *> workers_;
+        //! Number of workers reserved for interactive checks.
+        int reservedWorkerCount_;
+        //! Number of workers allowed to run project checks simultaneously.
+        int projectWorkerCount_;
+        //! Lane of running workers' shards.
+        QHash<const CppcheckWorker *, Lane *> workerLanes_;
+        //! Build directory slot of running workers' shards.
+        QHash<const CppcheckWorker *, int> workerSlots_;
+        //! Predicted check time of running workers' not checked files.
+        QHash<const CppcheckWorker *, qint64> workerCosts_;
         //! Plugin's settings.
         Settings *settings_;
+        //! Plugin's interned paths.
+        PathTable *paths_;
+        //! Historical check time of files.
+        CostModel costModel_;
+        //! Cached scheduling data of files by handle. Cleared on arguments or database change.
+        mutable QVector<FileInfo> fileInfos_;
         //! Binary run arguments.
         QStringList runArguments_;
-        //! Current project's include paths.
-        QStringList includePaths_;
-        //! Queued list of files to check.
-        QStringList fileCheckQueue_;
-        //! List of files currently being checked.
-        QStringList currentlyCheckingFiles_;
+        //! Binary run arguments for unused functions search.
+        QStringList unusedArguments_;
+        //! Handles of current project's include paths (for files out of project parts).
+        QVector<int> includePaths_;
+        //! Current project's directory.
+        QString projectDirectory_;
+        //! Output of binary's --version. Empty if incremental check is disabled.
+        QString binaryVersion_;
+        //! Analyzer info of current project.
+        BuildDirectory buildDirectory_;
+        //! Results of previous checks. Used only in cachePool_.
+        ResultCache resultCache_;
+        //! Single thread for result cache work (hashing files, reading results).
+        QThreadPool cachePool_;
+        //! Time since last cache size limiting.
+        QElapsedTimer cacheMaintenanceTimer_;
+        //! Running cache lookups.
+        QList<QFutureWatcher<CacheLookup> *> lookupWatchers_;
+        //! Files waiting for cache lookup by handle.
+        QHash<int, PendingLookup> pendingLookups_;
+        //! Last started cache lookup.
+        int lastLookup_;
+        //! Binary and arguments part of cache keys. Empty if result cache is not used.
+        QString cacheArguments_;
+        //! Result cache requests of looked up files until they are checked.
+        QHash<QString, CacheRequest> cacheRequests_;
+        //! Requests and results of running workers' done files.
+        //! Cached only if process finishes without crash.
+        QHash<const CppcheckWorker *, QList<QPair<CacheRequest, QList<Diagnostic> > > >
+        workerCacheEntries_;
+        //! Defines, include paths and standard of current project's sources.
+        CompilationDatabase compilationDatabase_;
+        //! Files of interactive checks. Checked before project ones.
+        Lane interactiveLane_;
+        //! Files of project checks.
+        Lane projectLane_;
+        //! Files of whole program check for unused functions.
+        Lane unusedLane_;
+        //! Jobs of files checked by configurations in parallel. Before interactive lane.
+        QList<ConfigJob> configJobs_;
+        //! Lane of configJobs_' workers in workerLanes_ (without files).
+        Lane configLane_;
+        //! Results of files checked by configurations.
+        QHash<QString, SplitResult> splitResults_;
         //! Should print process' output to MessageManager or not.
         bool showOutput_;
-        //! Show message Id in issue field.
-        bool showId_;
         //! Interface to inform about checking.
         QFutureInterface<void> *futureInterface_;
         //! Max summary arguments length.
         int maxArgumentsLength_;
-        //! Current file names in fileListFile_.
-        QStringList fileListFileContents_;
-        //! File that contains files to check (if there are too much run args).
-        QTemporaryFile fileListFile_;
-        //! File that contains include paths list (if there are too much run args).
-        QTemporaryFile includeListFile_;
+        //! Progress of current check session.
+        ProgressTracker progressTracker_;
     };
 
   } // namespace Internal
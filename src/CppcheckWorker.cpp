@@ -0,0 +1,227 @@
+#include <QDir>
+#include <QThread>
+
+#include <coreplugin/messagemanager.h>
+
+#include "CppcheckWorker.h"
+#include "CppcheckProcess.h"
+
+using namespace QtcCppcheck::Internal;
+
+CppcheckWorker::CppcheckWorker (QThread *ioThread, QObject *parent) :
+  QObject (parent), process_ (new CppcheckProcess), configurationCount_ (0),
+  isRunning_ (false), isCanceled_ (false), hasFailed_ (false), hasCrashed_ (false),
+  showOutput_ (false),
+  projectFile_ (QDir::tempPath () + QLatin1String ("/QtcCppcheck-XXXXXX.json")) {
+  Q_ASSERT (ioThread != NULL);
+  process_->moveToThread (ioThread);
+  connect (ioThread, &QThread::finished,
+           process_, &QObject::deleteLater);
+  connect (process_, &CppcheckProcess::eventsQueued,
+           this, &CppcheckWorker::takeEvents, Qt::QueuedConnection);
+}
+
+bool CppcheckWorker::start (const QString &binary, const QStringList &arguments,
+                            const QStringList &includes, const QStringList &files,
+                            const QByteArray &projectJson, int maxArgumentsLength) {
+  Q_ASSERT (!isRunning ());
+  files_ = files;
+  currentFile_.clear ();
+  configurationCount_ = 0;
+  checkedFiles_.clear ();
+  isCanceled_ = false;
+  hasFailed_ = false;
+  hasCrashed_ = false;
+
+  QStringList allArguments = arguments;
+  if (!projectJson.isEmpty ()) {
+    projectFile_.resize (0);
+    if (!projectFile_.open () || projectFile_.write (projectJson) != projectJson.size ()) {
+      projectFile_.close ();
+      Core::MessageManager::write (tr ("Failed to write cppcheck's project file"),
+                                   Core::MessageManager::Silent);
+      return false;
+    }
+    projectFile_.close ();
+    allArguments << QString (QLatin1String ("--project=%1")).arg (projectFile_.fileName ());
+  }
+  else if (!addFileArguments (allArguments, includes, maxArgumentsLength)) {
+    return false;
+  }
+  if (showOutput_) {
+    Core::MessageManager::write (QString ("Starting CppChecker with:%1, %2")
+                                 .arg (binary, allArguments.join (" ")), Core::MessageManager::WithFocus);
+  }
+  isRunning_ = true;
+  QMetaObject::invokeMethod (process_, "start", Qt::QueuedConnection,
+                             Q_ARG (QString, binary), Q_ARG (QStringList, allArguments),
+                             Q_ARG (bool, showOutput_));
+  return true;
+}
+
+bool CppcheckWorker::addFileArguments (QStringList &arguments, const QStringList &includes,
+                                       int maxArgumentsLength) {
+  int argumentLength = arguments.join (QLatin1Literal (" ")).length ();
+  int filesLength = files_.join (QLatin1Literal (" ")).length ();
+  int includesLength = includes.join (QLatin1Literal (" ")).length ();
+  if (argumentLength + includesLength + filesLength >= maxArgumentsLength) {
+    if (fileListFileContents_ != files_) {
+      fileListFileContents_ = files_;
+      fileListFile_.resize (0);
+      includeListFile_.resize (0);
+
+      if (fileListFile_.open () && includeListFile_.open ()) {
+        QByteArray filesArg = fileListFileContents_.join (QLatin1String ("\n")).toLocal8Bit ();
+        fileListFile_.write (filesArg);
+        fileListFile_.close ();
+
+        QStringList includeDirs = includes;
+        for (auto &i: includeDirs) {
+          i = i.mid (2);
+        }
+        QByteArray includesArg = includeDirs.join (QLatin1String ("\n")).toLocal8Bit ();
+        includeListFile_.write (includesArg);
+        includeListFile_.close ();
+      }
+      else{
+        fileListFileContents_.clear ();
+        Core::MessageManager::write (tr ("Failed to write cppcheck's argument files"),
+                                     Core::MessageManager::Silent);
+        return false;
+      }
+    }
+    arguments << QString (QLatin1String ("--file-list=%1")).arg (fileListFile_.fileName ());
+    arguments << QString (QLatin1String ("--includes-file=%1")).arg (includeListFile_.fileName ());
+  }
+  else{
+    arguments += files_;
+    arguments += includes;
+  }
+  return true;
+}
+
+void CppcheckWorker::kill () {
+  if (isRunning () && !isCanceled_) {
+    isCanceled_ = true;
+    QMetaObject::invokeMethod (process_, "kill", Qt::QueuedConnection);
+  }
+}
+
+bool CppcheckWorker::isRunning () const {
+  return isRunning_;
+}
+
+bool CppcheckWorker::isCanceled () const {
+  return isCanceled_;
+}
+
+bool CppcheckWorker::hasFailed () const {
+  return hasFailed_;
+}
+
+bool CppcheckWorker::hasCrashed () const {
+  return hasCrashed_;
+}
+
+const QStringList &CppcheckWorker::files () const {
+  return files_;
+}
+
+QStringList CppcheckWorker::uncheckedFiles () const {
+  QStringList files;
+  for (const auto &file: files_) {
+    if (!checkedFiles_.contains (file)) {
+      files << file;
+    }
+  }
+  return files;
+}
+
+const QString &CppcheckWorker::currentFile () const {
+  return currentFile_;
+}
+
+qint64 CppcheckWorker::currentFileElapsed () const {
+  return !currentFile_.isEmpty () ? fileTimer_.elapsed () : 0;
+}
+
+int CppcheckWorker::currentConfigCount () const {
+  return configurationCount_;
+}
+
+void CppcheckWorker::setShowOutput (bool showOutput) {
+  showOutput_ = showOutput;
+}
+
+void CppcheckWorker::takeEvents () {
+  process_->resetNotification ();
+  QString output;
+  QList<Diagnostic> diagnostics;
+  CppcheckProcess::Event event;
+  while (process_->takeEvent (event)) {
+    if (event.type == CppcheckProcess::Event::OutputWritten) {
+      output += (output.isEmpty () ? QString () : QString (QLatin1Char ('\n'))) + event.text;
+      continue;
+    }
+    // Results of killed process are not used.
+    if (isCanceled_ && event.type != CppcheckProcess::Event::StartFailed &&
+        event.type != CppcheckProcess::Event::Finished) {
+      continue;
+    }
+    switch (event.type) {
+      case CppcheckProcess::Event::FileStarted:
+        if (!diagnostics.isEmpty ()) { // Belong to previous file.
+          emit newTasks (diagnostics);
+          diagnostics.clear ();
+        }
+        currentFile_ = event.text;
+        configurationCount_ = 0;
+        fileTimer_.start ();
+        break;
+      case CppcheckProcess::Event::ConfigurationStarted:
+        ++configurationCount_;
+        break;
+      case CppcheckProcess::Event::FileChecked:
+        if (!diagnostics.isEmpty ()) { // Must be known before file is done.
+          emit newTasks (diagnostics);
+          diagnostics.clear ();
+        }
+        checkedFiles_.insert (event.text);
+        currentFile_.clear ();
+        emit fileChecked (event.text, event.value, event.configurations);
+        emit progressChanged ();
+        break;
+      case CppcheckProcess::Event::DiagnosticFound:
+        diagnostics.append (event.diagnostic);
+        break;
+      case CppcheckProcess::Event::StartFailed:
+        isCanceled_ = true;
+        hasFailed_ = true;
+        break;
+      case CppcheckProcess::Event::Finished:
+        if (!output.isEmpty ()) {
+          Core::MessageManager::write (output, Core::MessageManager::Silent);
+          output.clear ();
+        }
+        if (!diagnostics.isEmpty ()) {
+          emit newTasks (diagnostics);
+          diagnostics.clear ();
+        }
+        isRunning_ = false;
+        hasCrashed_ = (event.value != 0);
+        if (!hasCrashed_) {
+          currentFile_.clear ();
+        }
+        emit finished ();
+        break;
+      default:
+        break;
+    }
+  }
+  if (!output.isEmpty ()) {
+    Core::MessageManager::write (output, Core::MessageManager::Silent);
+  }
+  if (!diagnostics.isEmpty ()) {
+    emit newTasks (diagnostics);
+  }
+}
@@ -0,0 +1,121 @@
+#ifndef CPPCHECKWORKER_H
+#define CPPCHECKWORKER_H
+
+#include <QTemporaryFile>
+#include <QElapsedTimer>
+#include <QSet>
+#include <QStringList>
+
+#include "Diagnostic.h"
+
+class QThread;
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    class CppcheckProcess;
+
+    /*!
+     * \brief Single cppcheck process of CppcheckRunner's pool.
+     * Checks one shard of files at a time, reads result and progress.
+     * Does not decide what to check next (runner does on finished()).
+     * Process and its output parsing live in I/O thread (see CppcheckProcess),
+     * worker takes their results once per event loop iteration.
+     */
+    class CppcheckWorker : public QObject {
+      Q_OBJECT
+
+      public:
+        //! Process is deleted when ioThread finishes.
+        explicit CppcheckWorker (QThread *ioThread, QObject *parent = 0);
+
+        //! Start checking given files. Passes them via files if arguments are too long.
+        //! If projectJson is not empty, checks files of that compilation database instead.
+        //! Returns false if files could not be passed (process is not started then,
+        //! finished () is not emitted).
+        bool start (const QString &binary, const QStringList &arguments,
+                    const QStringList &includes, const QStringList &files,
+                    const QByteArray &projectJson, int maxArgumentsLength);
+        //! Kill running process. Its files are considered not checked.
+        void kill ();
+
+        bool isRunning () const;
+        //! Process was killed before finish.
+        bool isCanceled () const;
+        //! Process was not started.
+        bool hasFailed () const;
+        //! Process crashed or exited with error code so results of not checked files
+        //! are incomplete.
+        bool hasCrashed () const;
+        //! Files of current (or last) shard.
+        const QStringList &files () const;
+        //! Files of current shard that are not checked yet.
+        QStringList uncheckedFiles () const;
+        //! File being checked now if known. File that was checked when process crashed
+        //! after finish.
+        const QString &currentFile () const;
+        //! Check time of currentFile () in ms.
+        qint64 currentFileElapsed () const;
+        //! Number of started not default configurations of currentFile ().
+        int currentConfigCount () const;
+
+        void setShowOutput (bool showOutput);
+
+      signals:
+        //! New tasks have been generated. Tasks of file are emitted before fileChecked ().
+        void newTasks (const QList<Diagnostic> &diagnostics);
+        //! File of shard has been checked (after fileChecked ()).
+        void progressChanged ();
+        //! Single file of shard has been checked with given not default configurations.
+        void fileChecked (const QString &fileName, int elapsedMs,
+                          const QStringList &configurations);
+        //! Shard's process finished or failed to start.
+        void finished ();
+
+      private slots:
+        //! Handle events of process.
+        void takeEvents ();
+
+      private:
+        //! Add files_ and includes to arguments or to argument files if they are too long.
+        bool addFileArguments (QStringList &arguments, const QStringList &includes,
+                               int maxArgumentsLength);
+
+      private:
+        //! Binary runner in I/O thread.
+        CppcheckProcess *process_;
+        //! Files being checked.
+        QStringList files_;
+        //! File being checked now (from process' output).
+        QString currentFile_;
+        //! Check time of currentFile_.
+        QElapsedTimer fileTimer_;
+        //! Number of not default configurations of currentFile_ checked so far.
+        int configurationCount_;
+        //! Files of files_ that are checked already.
+        QSet<QString> checkedFiles_;
+        //! Process was started and not finished yet.
+        bool isRunning_;
+        //! Process was killed.
+        bool isCanceled_;
+        //! Process failed to start.
+        bool hasFailed_;
+        //! Process crashed.
+        bool hasCrashed_;
+        //! Should print process' output to MessageManager or not.
+        bool showOutput_;
+        //! Current file names in fileListFile_.
+        QStringList fileListFileContents_;
+        //! File that contains files to check (if there are too much run args).
+        QTemporaryFile fileListFile_;
+        //! File that contains include paths list (if there are too much run args).
+        QTemporaryFile includeListFile_;
+        //! Compilation database of files (cppcheck detects it by .json suffix).
+        QTemporaryFile projectFile_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+
+#endif // CPPCHECKWORKER_H
@@ -0,0 +1,54 @@
+#ifndef DIAGNOSTIC_H
+#define DIAGNOSTIC_H
+
+#include <QString>
+#include <QVector>
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    //! Place in source that diagnostic refers to.
+    struct DiagnosticLocation {
+      DiagnosticLocation () : line (0), column (0) {}
+
+      QString file;
+      int line;
+      int column;
+      //! Explanation of location (e.g. for call stack entries).
+      QString info;
+    };
+
+    /*!
+     * \brief Single issue reported by cppcheck.
+     * First location is the main one, others explain it (call stack, etc).
+     */
+    struct Diagnostic {
+      Diagnostic () : cwe (0), isInconclusive (false) {}
+
+      //! Severity's first letter ('e' for error, 'w' for warning, etc).
+      char type () const {
+        return !severity.isEmpty () ? severity.at (0).toLatin1 () : 'w';
+      }
+      QString file () const {
+        return !locations.isEmpty () ? locations.first ().file : QString ();
+      }
+      int line () const {
+        return !locations.isEmpty () ? locations.first ().line : 0;
+      }
+
+      QString id;
+      QString severity;
+      QString message;
+      QString verboseMessage;
+      //! Common weakness enumeration id or 0.
+      int cwe;
+      bool isInconclusive;
+      QVector<DiagnosticLocation> locations;
+      //! Checked file (translation unit) which check found issue.
+      QString checkedFile;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // DIAGNOSTIC_H
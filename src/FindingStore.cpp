@@ -0,0 +1,108 @@
+#include "FindingStore.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  const int minTableSize = 8;
+}
+
+int FindingStore::Table::probe (const TaskInfo &info, uint hash, bool &isFound) const {
+  Q_ASSERT (!slots.isEmpty ());
+  const int mask = slots.size () - 1;
+  int freeIndex = -1;
+  for (int i = int (hash & mask); ; i = (i + 1) & mask) {
+    const Slot &slot = slots.at (i);
+    if (slot.state == Slot::Empty) {
+      isFound = false;
+      return (freeIndex != -1) ? freeIndex : i;
+    }
+    if (slot.state == Slot::Removed) {
+      if (freeIndex == -1) {
+        freeIndex = i;
+      }
+    }
+    else if (slot.hash == hash && slot.info == info) {
+      isFound = true;
+      return i;
+    }
+  }
+}
+
+void FindingStore::Table::reserve () {
+  if ((used + 1) * 2 <= slots.size ()) {
+    return;
+  }
+  // Removed slots are dropped so table grows only if it is really full.
+  int size = qMax (minTableSize, slots.size ());
+  while ((count + 1) * 2 > size) {
+    size *= 2;
+  }
+  QVector<Slot> old (size);
+  old.swap (slots);
+  used = count;
+  const int mask = size - 1;
+  for (auto &slot: old) {
+    if (slot.state != Slot::Used) {
+      continue;
+    }
+    int i = int (slot.hash & mask);
+    while (slots.at (i).state != Slot::Empty) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+  }
+}
+
+TaskInfo &FindingStore::insert (const TaskInfo &info, bool &isAdded) {
+  Table &table = files_[info.file ()];
+  table.reserve ();
+  const uint hash = info.hash ();
+  bool isFound = false;
+  const int index = table.probe (info, hash, isFound);
+  Slot &slot = table.slots[index];
+  isAdded = !isFound;
+  if (isAdded) {
+    if (slot.state == Slot::Empty) {
+      ++table.used;
+    }
+    ++table.count;
+    slot.state = Slot::Used;
+    slot.hash = hash;
+    slot.info = info;
+  }
+  return slot.info;
+}
+
+void FindingStore::removeIf (int file,
+                             const std::function<bool(TaskInfo &)> &predicate) {
+  auto table = files_.find (file);
+  if (table == files_.end ()) {
+    return;
+  }
+  for (auto &slot: table->slots) {
+    if (slot.state == Slot::Used && predicate (slot.info)) {
+      slot.state = Slot::Removed;
+      slot.info = TaskInfo ();
+      --table->count;
+    }
+  }
+  if (table->count == 0) {
+    files_.erase (table);
+  }
+}
+
+QList<TaskInfo> FindingStore::takeFile (int file) {
+  QList<TaskInfo> infos;
+  const Table table = files_.take (file);
+  infos.reserve (table.count);
+  for (const auto &slot: table.slots) {
+    if (slot.state == Slot::Used) {
+      infos << slot.info;
+    }
+  }
+  return infos;
+}
+
+void FindingStore::clear () {
+  files_.clear ();
+}
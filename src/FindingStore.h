@@ -0,0 +1,61 @@
+#ifndef FINDINGSTORE_H
+#define FINDINGSTORE_H
+
+#include <functional>
+
+#include <QHash>
+#include <QVector>
+
+#include "TaskInfo.h"
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Added tasks by their files.
+     * Each file has own open addressing table keyed by task's line, checker
+     * and message handles, so duplicate search does not depend on number
+     * of file's tasks.
+     */
+    class FindingStore {
+      public:
+        //! Store task if there is no equal one. Returns stored task.
+        //! Reference is valid until next change of file's tasks.
+        TaskInfo &insert (const TaskInfo &info, bool &isAdded);
+        //! Remove tasks of file for which predicate returns true.
+        void removeIf (int file, const std::function<bool(TaskInfo &)> &predicate);
+        //! Remove all tasks of file and return them.
+        QList<TaskInfo> takeFile (int file);
+        void clear ();
+
+      private:
+        struct Slot {
+          enum State {Empty, Used, Removed};
+          Slot () : state (Empty), hash (0) {}
+          State state;
+          uint hash;
+          TaskInfo info;
+        };
+        struct Table {
+          Table () : count (0), used (0) {}
+          //! Index of equal task or of free slot to insert it. Table is not empty.
+          int probe (const TaskInfo &info, uint hash, bool &isFound) const;
+          //! Make room for one more task (keeps load factor below 1/2).
+          void reserve ();
+
+          //! Size is power of 2.
+          QVector<Slot> slots;
+          //! Used slots.
+          int count;
+          //! Used and removed slots.
+          int used;
+        };
+
+        //! Tables by file handles.
+        QHash<int, Table> files_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // FINDINGSTORE_H
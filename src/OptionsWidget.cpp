@@ -83,6 +83,11 @@ void OptionsWidget::applySettings () {
   settings_->setShowId (ui->showIdCheckBox->isChecked ());
   settings_->setPopupOnError (ui->popupOnErrorCheckBox->isChecked ());
   settings_->setPopupOnWarning (ui->popupOnWarningCheckBox->isChecked ());
+  settings_->setIncrementalCheck (ui->incrementalCheckBox->isChecked ());
+  settings_->setCacheSizeLimit (ui->cacheSizeSpinBox->value ());
+  settings_->setDependentsLimit (ui->dependentsSpinBox->value ());
+  settings_->setSkipExternal (ui->skipExternalCheckBox->isChecked ());
+  settings_->setVendorDirectories (ui->vendorEdit->text ().split (","));
   settings_->save ();
 }
 
@@ -102,4 +107,9 @@ void OptionsWidget::initInterface () {
   ui->showIdCheckBox->setChecked (settings_->showId ());
   ui->popupOnErrorCheckBox->setChecked (settings_->popupOnError ());
   ui->popupOnWarningCheckBox->setChecked (settings_->popupOnWarning ());
+  ui->incrementalCheckBox->setChecked (settings_->incrementalCheck ());
+  ui->cacheSizeSpinBox->setValue (settings_->cacheSizeLimit ());
+  ui->dependentsSpinBox->setValue (settings_->dependentsLimit ());
+  ui->skipExternalCheckBox->setChecked (settings_->skipExternal ());
+  ui->vendorEdit->setText (settings_->vendorDirectories ().join (","));
 }
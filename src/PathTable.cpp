@@ -0,0 +1,96 @@
+#include <algorithm>
+
+#include "PathTable.h"
+
+using namespace QtcCppcheck::Internal;
+
+quint64 PathTable::childKey (int parent, int name) {
+  return (quint64 (quint32 (parent + 1)) << 32) | quint32 (name);
+}
+
+int PathTable::intern (const QString &path) {
+  int handle = -1;
+  int begin = 0;
+  while (true) {
+    int end = path.indexOf (QLatin1Char ('/'), begin);
+    if (end == -1) {
+      end = path.size ();
+    }
+    const int name = names_.intern (path.mid (begin, end - begin));
+    const quint64 key = childKey (handle, name);
+    auto child = children_.constFind (key);
+    if (child != children_.constEnd ()) {
+      handle = child.value ();
+    }
+    else{
+      nodes_.append ({handle, name});
+      handle = nodes_.size () - 1;
+      children_.insert (key, handle);
+    }
+    if (end == path.size ()) {
+      return handle;
+    }
+    begin = end + 1;
+  }
+}
+
+QVector<int> PathTable::intern (const QStringList &paths) {
+  QVector<int> handles;
+  handles.reserve (paths.size ());
+  for (const auto &path: paths) {
+    handles.append (intern (path));
+  }
+  return handles;
+}
+
+int PathTable::find (const QString &path) const {
+  int handle = -1;
+  int begin = 0;
+  while (true) {
+    int end = path.indexOf (QLatin1Char ('/'), begin);
+    if (end == -1) {
+      end = path.size ();
+    }
+    const int name = names_.find (path.mid (begin, end - begin));
+    if (name == -1) {
+      return -1;
+    }
+    handle = children_.value (childKey (handle, name), -1);
+    if (handle == -1 || end == path.size ()) {
+      return handle;
+    }
+    begin = end + 1;
+  }
+}
+
+QString PathTable::path (int handle) const {
+  Q_ASSERT (handle >= 0 && handle < nodes_.size ());
+  int size = -1;
+  for (int i = handle; i != -1; i = nodes_.at (i).parent) {
+    size += names_.string (nodes_.at (i).name).size () + 1;
+  }
+  QString path (size, Qt::Uninitialized);
+  int end = size;
+  for (int i = handle; i != -1; i = nodes_.at (i).parent) {
+    const QString &name = names_.string (nodes_.at (i).name);
+    end -= name.size ();
+    std::copy (name.constBegin (), name.constEnd (), path.begin () + end);
+    if (end > 0) {
+      path[--end] = QLatin1Char ('/');
+    }
+  }
+  return path;
+}
+
+QStringList PathTable::paths (const QVector<int> &handles) const {
+  QStringList paths;
+  paths.reserve (handles.size ());
+  for (auto handle: handles) {
+    paths << path (handle);
+  }
+  return paths;
+}
+
+int PathTable::size () const {
+  return nodes_.size ();
+}
@@ -0,0 +1,52 @@
+#ifndef PATHTABLE_H
+#define PATHTABLE_H
+
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+
+#include "StringTable.h"
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Interned file paths referenced by integer handles.
+     * Paths are kept as directory tree: each path is its parent's handle
+     * and its last component, so common directories are stored once.
+     * Handles are never invalidated.
+     */
+    class PathTable {
+      public:
+        //! Handle of path. Adds path if it is new.
+        int intern (const QString &path);
+        QVector<int> intern (const QStringList &paths);
+        //! Handle of path or -1 if it is not added.
+        int find (const QString &path) const;
+        //! Path of valid handle.
+        QString path (int handle) const;
+        QStringList paths (const QVector<int> &handles) const;
+        int size () const;
+
+      private:
+        struct Node {
+          //! Handle of parent directory or -1.
+          int parent;
+          //! Handle of component in names_.
+          int name;
+        };
+
+        static quint64 childKey (int parent, int name);
+
+      private:
+        QVector<Node> nodes_;
+        //! Node handles by childKey ().
+        QHash<quint64, int> children_;
+        //! Path components.
+        StringTable names_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // PATHTABLE_H
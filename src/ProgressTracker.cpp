@@ -0,0 +1,40 @@
+#include <algorithm>
+
+#include "ProgressTracker.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  //! Throughput of shorter time is too noisy (process start, etc).
+  const qint64 minMeasureTimeMs = 2000;
+}
+
+ProgressTracker::ProgressTracker () :
+  doneCost_ (0) {
+}
+
+void ProgressTracker::start () {
+  timer_.start ();
+  doneCost_ = 0;
+}
+
+void ProgressTracker::addDone (qint64 cost) {
+  doneCost_ += std::max (cost, qint64 (0));
+}
+
+int ProgressTracker::percent (qint64 remainingCost) const {
+  const qint64 totalCost = doneCost_ + remainingCost;
+  return (totalCost > 0) ? int (100 * doneCost_ / totalCost) : 0;
+}
+
+qint64 ProgressTracker::remainingTime (qint64 remainingCost, int workerCount) const {
+  const qint64 historical = remainingCost / std::max (workerCount, 1);
+  const qint64 elapsed = timer_.isValid () ? timer_.elapsed () : 0;
+  if (doneCost_ == 0 || elapsed < minMeasureTimeMs) {
+    return historical;
+  }
+  const qint64 observed = remainingCost * elapsed / doneCost_;
+  // Trust observation more when more work is done.
+  const double weight = double (doneCost_) / (doneCost_ + remainingCost);
+  return qint64 (weight * observed + (1 - weight) * historical);
+}
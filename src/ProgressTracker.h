@@ -0,0 +1,39 @@
+#ifndef PROGRESSTRACKER_H
+#define PROGRESSTRACKER_H
+
+#include <QElapsedTimer>
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Progress and remaining time of check session.
+     * Work is measured in predicted (historical) check time of files.
+     * Remaining time is based on historical costs at start and moves
+     * to observed throughput (that includes real parallelism and load)
+     * as more files are checked.
+     */
+    class ProgressTracker {
+      public:
+        ProgressTracker ();
+
+        //! Start new check session.
+        void start ();
+        //! File (or its part) of given predicted cost has been checked.
+        void addDone (qint64 cost);
+
+        //! Done percentage.
+        int percent (qint64 remainingCost) const;
+        //! Predicted time of checking remaining files in ms.
+        qint64 remainingTime (qint64 remainingCost, int workerCount) const;
+
+      private:
+        QElapsedTimer timer_;
+        //! Predicted cost of checked files.
+        qint64 doneCost_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // PROGRESSTRACKER_H
@@ -1,7 +1,10 @@
 #include <QAction>
 #include <QTranslator>
 #include <QMenu>
-#include <QRegExp>
+#include <QRegularExpression>
+#include <QDir>
+
+#include <algorithm>
 
 #include <coreplugin/icore.h>
 #include <coreplugin/icontext.h>
@@ -9,11 +12,15 @@
 #include <coreplugin/actionmanager/actioncontainer.h>
 #include <coreplugin/coreconstants.h>
 #include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/editormanager/ieditor.h>
 #include <coreplugin/idocument.h>
+#include <coreplugin/messagemanager.h>
 
 #include <projectexplorer/projectexplorer.h>
 #include <projectexplorer/projectnodes.h>
 #include <projectexplorer/project.h>
+#include <projectexplorer/target.h>
+#include <projectexplorer/buildconfiguration.h>
 #include <projectexplorer/taskhub.h>
 #include <projectexplorer/buildmanager.h>
 #include <projectexplorer/session.h>
@@ -23,6 +30,10 @@
 #include <cpptools/projectpart.h>
 #include <cpptools/cppmodelmanager.h>
 
+#include <utils/runextensions.h>
+
+#include <cplusplus/CppDocument.h>
+
 #include <QtPlugin>
 
 #include "QtcCppcheckPlugin.h"
@@ -31,6 +42,7 @@
 #include "OptionsPage.h"
 #include "TaskInfo.h"
 #include "CppcheckRunner.h"
+#include "Diagnostic.h"
 
 using namespace QtcCppcheck::Internal;
 
@@ -44,43 +56,70 @@ namespace {
     }
   }
 
-  QStringList supportedExtensions () {
-    QStringList extensions;
-    extensions << QLatin1String ("cpp") << QLatin1String ("cxx") << QLatin1String ("cc")
-               << QLatin1String ("c") << QLatin1String ("c++") << QLatin1String ("txx")
-               << QLatin1String ("tpp")
-               << QLatin1String ("h") << QLatin1String ("hh") << QLatin1String ("hpp")
-               << QLatin1String ("h++") << QLatin1String ("hxx");
-    return extensions;
+  //! Kind of file by its extension.
+  enum FileKind {OtherFile, SourceFile, HeaderFile};
+
+  FileKind fileKind (const QString &name) {
+    static const QHash<QString, FileKind> kinds {
+      {QLatin1String ("cpp"), SourceFile}, {QLatin1String ("cxx"), SourceFile},
+      {QLatin1String ("cc"), SourceFile}, {QLatin1String ("c"), SourceFile},
+      {QLatin1String ("c++"), SourceFile},
+      {QLatin1String ("h"), HeaderFile}, {QLatin1String ("hh"), HeaderFile},
+      {QLatin1String ("hpp"), HeaderFile}, {QLatin1String ("h++"), HeaderFile},
+      {QLatin1String ("hxx"), HeaderFile}, {QLatin1String ("txx"), HeaderFile},
+      {QLatin1String ("tpp"), HeaderFile}
+    };
+    const int dot = name.lastIndexOf (QLatin1Char ('.'));
+    if (dot == -1 || dot < name.lastIndexOf (QLatin1Char ('/'))) {
+      return OtherFile;
+    }
+    return kinds.value (name.mid (dot + 1), OtherFile);
   }
 
-  bool isFilteredOut (const QString &name, const QList<QRegExp> &filters) {
-    for (const auto &filter: filters) {
-      if (filter.exactMatch (name)) {
-        return true;
-      }
-    }
-    return false;
+  bool isHeader (const QString &name) {
+    return fileKind (name) == HeaderFile;
   }
 
-  //! Check if node with given name should me checked.
-  bool isFileNodeCheckable (const QString &name) {
-    static QStringList extensions = supportedExtensions ();
-    QFileInfo info (name);
-    QString extension = info.completeSuffix ();
-    return (extensions.contains (extension));
+  //! Regular expression of wildcard pattern (same syntax as QRegExp::Wildcard).
+  QString wildcardExpression (const QString &pattern) {
+    QString expression;
+    for (int i = 0, end = pattern.size (); i < end; ++i) {
+      const QChar c = pattern.at (i);
+      if (c == QLatin1Char ('*')) {
+        expression += QLatin1String (".*");
+      }
+      else if (c == QLatin1Char ('?')) {
+        expression += QLatin1Char ('.');
+      }
+      else if (c == QLatin1Char ('[') && pattern.indexOf (QLatin1Char (']'), i + 2) != -1) {
+        const int close = pattern.indexOf (QLatin1Char (']'), i + 2);
+        QString set = pattern.mid (i + 1, close - i - 1);
+        // Negated by '^' as in QRegExp::Wildcard ('!' is literal there).
+        set.replace (QLatin1Char ('\\'), QLatin1String ("\\\\"));
+        expression += QLatin1Char ('[') + set + QLatin1Char (']');
+        i = close;
+      }
+      else{
+        expression += QRegularExpression::escape (QString (c));
+      }
+    }
+    return expression;
   }
 }
 
 QtcCppcheckPlugin::QtcCppcheckPlugin () :
   IPlugin (), settings_ (new Settings (true)),
-  runner_ (new CppcheckRunner (settings_, this)) {
+  runner_ (new CppcheckRunner (settings_, &paths_, this)), hasProjectListChanges_ (false),
+  isProjectListOutdated_ (false), skippedFileCount_ (-1), usageCounter_ (0) {
+  connect (&projectFilesWatcher_, &QFutureWatcher<ProjectFiles>::finished,
+           this, &QtcCppcheckPlugin::handleProjectFileListUpdated);
   // Create your members
 }
 
 QtcCppcheckPlugin::~QtcCppcheckPlugin () {
   // Unregister objects from the plugin manager's object pool
   // Delete members
+  projectFilesWatcher_.waitForFinished ();
 
   delete settings_;
 }
@@ -147,10 +186,8 @@ void QtcCppcheckPlugin::initMenus () {
 }
 
 void QtcCppcheckPlugin::initConnections () {
-  connect (runner_, &CppcheckRunner::newTask,
-           this, &QtcCppcheckPlugin::addTask);
-  connect (runner_, &CppcheckRunner::startedChecking,
-           this, &QtcCppcheckPlugin::clearTasksForFiles);
+  connect (runner_, &CppcheckRunner::filesChecked,
+           this, &QtcCppcheckPlugin::commitTasks);
 
   connect (SessionManager::instance (), &SessionManager::aboutToUnloadSession,
            this, &QtcCppcheckPlugin::handleSessionUnload);
@@ -167,6 +204,13 @@ void QtcCppcheckPlugin::initConnections () {
            this, &QtcCppcheckPlugin::handleDocumentsChange);
   connect (DocumentModel::model (), &QAbstractItemModel::rowsAboutToBeRemoved,
            this, &QtcCppcheckPlugin::handleDocumentsClose);
+  // Recently used sources are checked first when their header is saved.
+  connect (EditorManager::instance (), &EditorManager::currentEditorChanged,
+           this, [this] (IEditor *editor) {
+    if (editor != NULL && editor->document () != NULL) {
+      documentUsage_.insert (editor->document ()->filePath ().toString (), ++usageCounter_);
+    }
+  });
 }
 
 void QtcCppcheckPlugin::initLanguage () {
@@ -198,10 +242,11 @@ ExtensionSystem::IPlugin::ShutdownFlag QtcCppcheckPlugin::aboutToShutdown () {
   return SynchronousShutdown;
 }
 
-void QtcCppcheckPlugin::checkFiles (const QStringList &fileNames) {
+void QtcCppcheckPlugin::checkFiles (const QStringList &fileNames, bool isInteractive) {
   Q_ASSERT (runner_ != NULL);
   Q_ASSERT (!fileNames.isEmpty ());
-  runner_->checkFiles (fileNames);
+  runner_->checkFiles (fileNames, isInteractive ? CppcheckRunner::InteractiveCheck
+                       : CppcheckRunner::ProjectCheck);
 }
 
 void QtcCppcheckPlugin::checkCurrentDocument () {
@@ -210,16 +255,17 @@ void QtcCppcheckPlugin::checkCurrentDocument () {
     return;
   }
   // Check event if it not belongs to active project.
-  checkFiles (QStringList () << document->filePath ().toString ());
+  checkFiles (QStringList () << document->filePath ().toString (), true);
 }
 
 void QtcCppcheckPlugin::checkActiveProject () {
-  if (projectFileList_.isEmpty ()) {
-    updateProjectFileList ();
-  }
-  if (!projectFileList_.isEmpty ()) {
-    checkFiles (projectFileList_);
-  }
+  whenProjectListed ([this] {
+    if (!projectFiles_.isEmpty ()) {
+      const QStringList files = paths_.paths (projectFiles_);
+      checkFiles (files, false);
+      runner_->checkUnusedFunctions (files);
+    }
+  });
 }
 
 void QtcCppcheckPlugin::checkCurrentNode () {
@@ -230,21 +276,88 @@ void QtcCppcheckPlugin::checkCurrentNode () {
 
   QStringList files = checkableFiles (node, true);
   if (!files.isEmpty ()) {
-    checkFiles (files);
+    checkFiles (files, true);
+  }
+}
+
+void QtcCppcheckPlugin::collectFiles (const Node *node, QStringList &files,
+                                      QStringList &generatedFiles) {
+  if (const auto *container = node->asContainerNode ()) {
+    node = container->rootProjectNode ();
+    if (!node) {
+      return;
+    }
+  }
+  if (const auto *folder = node->asFolderNode ()) {
+    for (const auto *subfolder: folder->folderNodes ()) {
+      collectFiles (subfolder, files, generatedFiles);
+    }
+    for (const auto *file: folder->fileNodes ()) {
+      (file->isGenerated () ? generatedFiles : files) << file->filePath ().toString ();
+    }
+  }
+  else if (const auto *file = node->asFileNode ()) {
+    (file->isGenerated () ? generatedFiles : files) << file->filePath ().toString ();
   }
 }
 
 QStringList QtcCppcheckPlugin::checkableFiles (const Node *node, bool forceSelected) const {
-  if (!node) {
-    return {};
+  QStringList files;
+  collectCheckableFiles (node, forceSelected, externalFilter (ProjectTree::projectForNode (node)),
+                         files);
+  return files;
+}
+
+QtcCppcheckPlugin::ExternalFilter QtcCppcheckPlugin::externalFilter (const Project *project) const {
+  Q_ASSERT (settings_ != NULL);
+  ExternalFilter filter;
+  if (project == NULL || !settings_->skipExternal ()) {
+    return filter;
+  }
+  filter.isEnabled = true;
+  filter.projectDirectory = project->projectDirectory ().toString () + QLatin1Char ('/');
+  filter.vendorExpression = vendorExpression_;
+  const Target *target = project->activeTarget ();
+  const BuildConfiguration *configuration = target ? target->activeBuildConfiguration () : NULL;
+  if (configuration != NULL) {
+    const QString buildDirectory = configuration->buildDirectory ().toString () + QLatin1Char ('/');
+    // In-source build directory contains sources too.
+    if (!filter.projectDirectory.startsWith (buildDirectory)) {
+      filter.buildDirectory = buildDirectory;
+    }
   }
+  return filter;
+}
 
-  QList<QRegExp> filters;
-  for (const auto &i: settings_->ignorePatterns ()) {
-    filters << QRegExp (i, Qt::CaseSensitive, QRegExp::Wildcard);
+bool QtcCppcheckPlugin::ExternalFilter::matches (const QString &name) const {
+  if (!isEnabled) {
+    return false;
+  }
+  if (!buildDirectory.isEmpty () && name.startsWith (buildDirectory)) {
+    return true;
+  }
+  // Outputs of moc, rcc and uic placed near sources.
+  const QStringRef fileName = name.midRef (name.lastIndexOf (QLatin1Char ('/')) + 1);
+  const bool isGeneratedSource = fileName.endsWith (QLatin1String (".cpp")) &&
+                                 (fileName.startsWith (QLatin1String ("moc_")) ||
+                                  fileName.startsWith (QLatin1String ("qrc_")));
+  const bool isGeneratedHeader = fileName.endsWith (QLatin1String (".h")) &&
+                                 fileName.startsWith (QLatin1String ("ui_"));
+  if (isGeneratedSource || isGeneratedHeader) {
+    return true;
+  }
+  // Project itself can be placed in directory with vendor-like name.
+  return !vendorExpression.pattern ().isEmpty () && name.startsWith (projectDirectory) &&
+         vendorExpression.match (name.midRef (projectDirectory.size ())).hasMatch ();
+}
+
+void QtcCppcheckPlugin::collectCheckableFiles (const Node *node, bool forceSelected,
+                                               const ExternalFilter &filter,
+                                               QStringList &files) const {
+  if (!node) {
+    return;
   }
 
-  QStringList files;
   const FolderNode *folder = nullptr;
   if (const auto *container = node->asContainerNode ()) {
     folder = container->rootProjectNode ();
@@ -255,46 +368,179 @@ QStringList QtcCppcheckPlugin::checkableFiles (const Node *node, bool forceSelec
 
   if (folder) {
     for (const auto *subfolder: folder->folderNodes ()) {
-      files += checkableFiles (subfolder, false); // force only selected, not its children
+      collectCheckableFiles (subfolder, false, filter, files); // force only selected, not its children
     }
     for (const auto *file: folder->fileNodes ()) {
-      files += checkableFiles (file, false); // force only selected, not its children
+      collectCheckableFiles (file, false, filter, files); // force only selected, not its children
     }
   }
   else if (const auto *file = node->asFileNode ()) {
     auto name = file->filePath ().toString ();
-    if (forceSelected || (isFileNodeCheckable (name) && !isFilteredOut (name, filters))) {
+    if (forceSelected || (fileKind (name) != OtherFile &&
+                          (ignoreExpression_.pattern ().isEmpty () ||
+                           !ignoreExpression_.match (name).hasMatch ()) &&
+                          !(filter.isEnabled && file->isGenerated ()) && !filter.matches (name))) {
       files << name;
     }
   }
-
-  return files;
 }
 
 void QtcCppcheckPlugin::updateProjectFileList () {
-  if (activeProject_) {
-
-    const auto *modelManager = CppTools::CppModelManager::instance ();
-    auto info = modelManager->projectInfo (activeProject_);
+  if (projectFilesWatcher_.isRunning ()) { // Restarted when finished.
+    isProjectListOutdated_ = true;
+    return;
+  }
+  if (activeProject_.isNull ()) {
+    projectFiles_.clear ();
+    projectFileSet_.clear ();
+    listedProject_.clear ();
+    const auto actions = projectListedActions_;
+    projectListedActions_.clear ();
+    for (const auto &action: actions) {
+      action ();
+    }
+    return;
+  }
+  // Nodes and code model info can change any time so only their copies
+  // are used in background.
+  QStringList files;
+  QStringList generatedFiles;
+  if (ProjectNode *rootNode = activeProject_->rootProjectNode ()) {
+    collectFiles (rootNode, files, generatedFiles);
+  }
+  const ExternalFilter filter = externalFilter (activeProject_.data ());
+  if (!filter.isEnabled) { // Checked as others.
+    files += generatedFiles;
+    generatedFiles.clear ();
+  }
+  const auto info = CppTools::CppModelManager::instance ()->projectInfo (activeProject_);
+  const auto projectPath = activeProject_->projectDirectory ().toString ();
+  projectFilesProject_ = activeProject_;
+  projectFilesWatcher_.setFuture (Utils::runAsync (&QtcCppcheckPlugin::enumerateProjectFiles,
+                                                   files, generatedFiles, ignoreExpression_,
+                                                   filter, info, projectPath));
+}
 
-    const auto projectPath = activeProject_->projectDirectory ().toString ();
-    QStringList paths;
-    for (const auto &i: info.projectParts ()) {
-      for (const auto &j: i->headerPaths) {
-        if (j.type == HeaderPathType::User &&
-            j.path.startsWith (projectPath)) {
-          paths.append (j.path);
-        }
+void QtcCppcheckPlugin::enumerateProjectFiles (QFutureInterface<ProjectFiles> &futureInterface,
+                                               const QStringList &files,
+                                               const QStringList &generatedFiles,
+                                               const QRegularExpression &ignoreExpression,
+                                               const ExternalFilter &externalFilter,
+                                               const CppTools::ProjectInfo &info,
+                                               const QString &projectPath) {
+  ProjectFiles result;
+  result.info = info;
+  result.projectPath = projectPath;
+  for (const auto &i: info.projectParts ()) {
+    for (const auto &j: i->headerPaths) {
+      if (j.type == HeaderPathType::User &&
+          j.path.startsWith (projectPath)) {
+        result.includePaths.append (j.path);
       }
     }
+  }
+  result.includePaths.removeDuplicates ();
 
-    paths.removeDuplicates ();
-    runner_->setIncludePaths (paths);
+  const auto isCheckable = [&ignoreExpression] (const QString &name) {
+    return fileKind (name) != OtherFile &&
+           (ignoreExpression.pattern ().isEmpty () || !ignoreExpression.match (name).hasMatch ());
+  };
+  result.files.reserve (files.size ());
+  for (const auto &name: files) {
+    if (isCheckable (name)) {
+      (externalFilter.matches (name) ? result.skippedFiles : result.files) << name;
+    }
+  }
+  for (const auto &name: generatedFiles) {
+    if (isCheckable (name)) {
+      result.skippedFiles << name;
+    }
+  }
+  result.skippedFiles.removeDuplicates ();
+  futureInterface.reportResult (result);
+}
 
-    if (ProjectNode *rootNode = activeProject_->rootProjectNode ()) {
-      projectFileList_ = checkableFiles (rootNode);
+void QtcCppcheckPlugin::handleProjectFileListUpdated () {
+  const bool isOutdated = isProjectListOutdated_ ||
+                          projectFilesProject_.data () != activeProject_.data ();
+  isProjectListOutdated_ = false;
+  if (isOutdated || projectFilesWatcher_.future ().resultCount () == 0) {
+    updateProjectFileList ();
+    return;
+  }
+  const ProjectFiles result = projectFilesWatcher_.result ();
+  Q_ASSERT (runner_ != NULL);
+  runner_->setIncludePaths (result.includePaths);
+  runner_->setProjectInfo (result.info, result.projectPath);
+
+  // Paths table is not shared with background so files are interned here.
+  QVector<int> files;
+  files.reserve (result.files.size ());
+  QSet<int> fileSet;
+  fileSet.reserve (result.files.size ());
+  for (const auto &name: result.files) {
+    const int file = paths_.intern (name);
+    if (!fileSet.contains (file)) {
+      fileSet.insert (file);
+      files << file;
     }
   }
+  // Swap at once, previous list was used until now.
+  QSet<int> oldFiles;
+  oldFiles.swap (projectFileSet_);
+  projectFileSet_.swap (fileSet);
+  projectFiles_.swap (files);
+  listedProject_ = activeProject_;
+
+  if (result.skippedFiles.size () != skippedFileCount_) {
+    skippedFileCount_ = result.skippedFiles.size ();
+    if (skippedFileCount_ > 0) {
+      const qint64 savedSeconds = runner_->predictedCost (result.skippedFiles) / 1000;
+      MessageManager::write (tr ("Cppcheck: %1 generated or third-party file(s) of project "
+                                 "are not checked, about %2 s of check time saved")
+                             .arg (skippedFileCount_).arg (savedSeconds),
+                             MessageManager::Silent);
+    }
+  }
+
+  if (hasProjectListChanges_) {
+    hasProjectListChanges_ = false;
+    QStringList addedFiles;
+    for (auto file: projectFiles_) {
+      if (!oldFiles.contains (file)) {
+        addedFiles << paths_.path (file);
+      }
+    }
+    QStringList removedFiles;
+    for (auto file: oldFiles) {
+      if (!projectFileSet_.contains (file)) {
+        removedFiles << paths_.path (file);
+      }
+    }
+    if (!removedFiles.isEmpty ()) {
+      clearTasksForFiles (removedFiles);
+    }
+
+    if (settings_->checkOnFileAdd () && !addedFiles.isEmpty ()) {
+      checkFiles (addedFiles, false);
+      runner_->checkUnusedFunctions (paths_.paths (projectFiles_));
+    }
+  }
+
+  const auto actions = projectListedActions_;
+  projectListedActions_.clear ();
+  for (const auto &action: actions) {
+    action ();
+  }
+}
+
+void QtcCppcheckPlugin::whenProjectListed (const std::function<void ()> &action) {
+  if (!activeProject_.isNull () && listedProject_.data () != activeProject_.data ()) {
+    projectListedActions_ << action;
+    updateProjectFileList ();
+    return;
+  }
+  action ();
 }
 
 void QtcCppcheckPlugin::handleStartupProjectChange (Project *project) {
@@ -303,9 +549,11 @@ void QtcCppcheckPlugin::handleStartupProjectChange (Project *project) {
                 this, &QtcCppcheckPlugin::handleProjectFileListChanged);
   }
   activeProject_ = project;
+  skippedFileCount_ = -1;
   handleProjectFileListChanged ();
   Q_ASSERT (runner_ != NULL);
-  runner_->stopChecking ();
+  runner_->clear (); // Results of previous project.
+  runner_->setProjectDirectory (project ? project->projectDirectory ().toString () : QString ());
   if (project == NULL) {
     return;
   }
@@ -319,34 +567,21 @@ void QtcCppcheckPlugin::handleStartupProjectChange (Project *project) {
 
 void QtcCppcheckPlugin::handleProjectFileListChanged () {
   if (activeProject_.isNull ()) {
-    projectFileList_.clear ();
+    projectFiles_.clear ();
+    projectFileSet_.clear ();
+    listedProject_.clear ();
     clearTasksForFiles ();
     return;
   }
-
-  QStringList oldFiles = projectFileList_;
+  // Added and removed files are handled when new list is ready.
+  hasProjectListChanges_ = true;
   updateProjectFileList ();
-  QStringList addedFiles;
-  foreach (const QString &file, projectFileList_) {
-    if (oldFiles.contains (file)) {
-      oldFiles.removeAll (file);
-      continue;
-    }
-    addedFiles << file;
-  }
-  if (!oldFiles.isEmpty ()) {
-    clearTasksForFiles (oldFiles); // Removed files.
-  }
-
-  if (settings_->checkOnFileAdd () && !addedFiles.isEmpty ()) {
-    checkFiles (addedFiles);
-  }
 }
 
 void QtcCppcheckPlugin::handleSessionUnload () {
-  clearTasksForFiles ();
   Q_ASSERT (runner_ != NULL);
-  runner_->stopChecking ();
+  runner_->clear ();
+  clearTasksForFiles ();
 }
 
 void QtcCppcheckPlugin::handleBuildStateChange (Project *project) {
@@ -379,7 +614,7 @@ void QtcCppcheckPlugin::handleDocumentsClose (const QModelIndex &parent,
 
 void QtcCppcheckPlugin::checkActiveProjectDocuments (int beginRow, int endRow,
                                                      bool modifiedFlag) {
-  QStringList filesToCheck;
+  QStringList documents;
   for (int row = beginRow; row <= endRow; ++row) {
     DocumentModel::Entry *entry = DocumentModel::entryAtRow (row);
     if (entry == NULL) {
@@ -389,66 +624,206 @@ void QtcCppcheckPlugin::checkActiveProjectDocuments (int beginRow, int endRow,
     if (document == NULL) {
       continue;
     }
-    if (projectFileList_.isEmpty ()) {
-      updateProjectFileList ();
-    }
-    if (projectFileList_.contains (document->filePath ().toString ()) &&
-        document->isModified () == modifiedFlag) {
-      filesToCheck << document->filePath ().toString ();
+    if (document->isModified () == modifiedFlag) {
+      documents << document->filePath ().toString ();
     }
   }
-
-  if (!filesToCheck.isEmpty ()) {
-    checkFiles (filesToCheck);
+  if (documents.isEmpty ()) {
+    return;
   }
+
+  whenProjectListed ([this, documents] {
+    QStringList filesToCheck;
+    for (const auto &document: documents) {
+      if (projectFileSet_.contains (paths_.find (document))) {
+        filesToCheck << document;
+      }
+    }
+    if (filesToCheck.isEmpty ()) {
+      return;
+    }
+    const QStringList checkedFiles = withDependents (filesToCheck);
+    // Header replaced by its sources is not committed alone, drop its own results.
+    for (const auto &file: filesToCheck) {
+      if (!checkedFiles.contains (file)) {
+        removeUnitTasks (paths_.find (file), {});
+      }
+    }
+    checkFiles (checkedFiles, true);
+  });
 }
 
-void QtcCppcheckPlugin::addTask (char type, const QString &id, const QString &description,
-                                 const QString &fileName, int line) {
-  QFileInfo info (fileName);
-  if (!info.exists ()) { // Not points to file.
-    return;
+QStringList QtcCppcheckPlugin::withDependents (const QStringList &files) const {
+  Q_ASSERT (settings_ != NULL);
+  const int limit = settings_->dependentsLimit ();
+  if (limit <= 0) {
+    return files;
+  }
+  QStringList result;
+  CPlusPlus::Snapshot snapshot;
+  bool hasSnapshot = false;
+  for (const auto &file: files) {
+    if (!isHeader (file)) {
+      result << file;
+      continue;
+    }
+    if (!hasSnapshot) {
+      snapshot = CppTools::CppModelManager::instance ()->snapshot ();
+      hasSnapshot = true;
+    }
+    // Snapshot's dependency table is code model's reverse include graph.
+    QStringList dependents;
+    for (const auto &dependent: snapshot.filesDependingOn (Utils::FileName::fromString (file))) {
+      const QString name = dependent.toString ();
+      if (!isHeader (name) && projectFileSet_.contains (paths_.find (name))) {
+        dependents << name;
+      }
+    }
+    if (dependents.isEmpty ()) { // Not included by sources, check alone.
+      result << file;
+      continue;
+    }
+    std::stable_sort (dependents.begin (), dependents.end (),
+                      [this] (const QString &l, const QString &r) {
+      return documentUsage_.value (l) > documentUsage_.value (r);
+    });
+    result += dependents.mid (0, limit);
+  }
+  result.removeDuplicates ();
+  return result;
+}
+
+void QtcCppcheckPlugin::commitTasks (const QStringList &files,
+                                     const QList<Diagnostic> &diagnostics) {
+  Q_ASSERT (settings_ != NULL);
+  // Tasks reported by checked files (keys) in this batch.
+  QHash<int, QSet<TaskInfo> > reported;
+  const bool showId = settings_->showId ();
+  bool hasErrors = false;
+  bool hasWarnings = false;
+  // Repeats and diagnostics without files are dropped in I/O thread.
+  for (const auto &diagnostic: diagnostics) {
+    if (!addTask (diagnostic, showId, reported)) {
+      continue;
+    }
+    if (diagnostic.type () == 'e') {
+      hasErrors = true;
+    }
+    else{
+      hasWarnings = true;
+    }
   }
-  Utils::FileName file (info);
-  QString fullDescription = QLatin1String (Constants::TASK_CATEGORY_NAME) +
-                            ( id.isEmpty () ? QString ("") : QLatin1String ("(") + id + QLatin1String (")") ) +
-                            QLatin1String (": ") + description;
-  TaskInfo taskInfo (line, fullDescription);
+  // Only vanished findings of rechecked files are removed.
+  for (const auto &file: files) {
+    const int unit = paths_.find (file);
+    if (unit != -1) {
+      removeUnitTasks (unit, reported.value (unit));
+    }
+  }
+  // Single popup for whole batch.
+  if ((hasErrors && settings_->popupOnError ()) || (hasWarnings && settings_->popupOnWarning ())) {
+    TaskHub::requestPopup ();
+  }
+}
+
+bool QtcCppcheckPlugin::addTask (const Diagnostic &diagnostic, bool showId,
+                                 QHash<int, QSet<TaskInfo> > &reported) {
+  const QString fileName = diagnostic.file ();
+  QString text = diagnostic.message;
+  if (diagnostic.cwe > 0) {
+    text += QString (QLatin1String (" [CWE-%1]")).arg (diagnostic.cwe);
+  }
+  // Other locations are shown in expanded task.
+  for (int i = 1, end = diagnostic.locations.size (); i < end; ++i) {
+    const auto &location = diagnostic.locations.at (i);
+    text += QString (QLatin1String ("\n%1:%2:%3: %4"))
+            .arg (QDir::toNativeSeparators (location.file)).arg (location.line)
+            .arg (location.column).arg (location.info);
+  }
+  const int checker = (showId && !diagnostic.id.isEmpty ()) ? checkers_.intern (diagnostic.id) : -1;
+  const int unit = paths_.intern (diagnostic.checkedFile);
+  TaskInfo taskInfo (paths_.intern (fileName), diagnostic.line (), checker, messages_.intern (text));
+  reported[unit].insert (taskInfo);
+  unitFiles_[unit].insert (taskInfo.file ());
   // Search for duplicates (see TaskInfo class description).
-  if (fileTasks_.values (fileName).contains (taskInfo)) {
-    return;
+  bool isAdded = false;
+  TaskInfo &storedInfo = findings_.insert (taskInfo, isAdded);
+  storedInfo.addUnit (unit);
+  if (!isAdded) {
+    return false;
   }
 
-  Task::TaskType taskType = (type == 'e') ? Task::Error : Task::Warning;
-  Task task (taskType, fullDescription, file, line, Constants::TASK_CATEGORY_ID);
+  Task::TaskType taskType = (diagnostic.type () == 'e') ? Task::Error : Task::Warning;
+  Task task (taskType, taskDescription (storedInfo), Utils::FileName::fromString (fileName),
+             storedInfo.line (), Constants::TASK_CATEGORY_ID);
   TaskHub::addTask (task);
-  Q_ASSERT (settings_ != NULL);
-  bool shouldPopup = (taskType == Task::Error) ? settings_->popupOnError ()
-                     : settings_->popupOnWarning ();
-  if (shouldPopup) {
-    TaskHub::requestPopup ();
+  storedInfo.setId (task.taskId);
+  return true;
+}
+
+QString QtcCppcheckPlugin::taskDescription (const TaskInfo &info) const {
+  QString description = QLatin1String (Constants::TASK_CATEGORY_NAME);
+  if (info.checker () != -1) {
+    description += QLatin1String ("(") + checkers_.string (info.checker ()) + QLatin1String (")");
   }
+  return description + QLatin1String (": ") + messages_.string (info.message ());
+}
 
-  taskInfo = task;
-  fileTasks_.insertMulti (fileName, taskInfo);
+void QtcCppcheckPlugin::removeUnitTasks (int unit, const QSet<TaskInfo> &reported) {
+  auto files = unitFiles_.find (unit);
+  if (files == unitFiles_.end ()) {
+    return;
+  }
+  Task task;
+  for (auto file = files->begin (); file != files->end (); ) {
+    bool hasTasks = false;
+    findings_.removeIf (*file, [&] (TaskInfo &info) {
+      if (!info.hasUnit (unit)) {
+        return false;
+      }
+      if (reported.contains (info)) {
+        hasTasks = true;
+        return false;
+      }
+      if (!info.removeUnit (unit)) {
+        return false;
+      }
+      info.init (task);
+      TaskHub::removeTask (task);
+      return true;
+    });
+    if (hasTasks) {
+      ++file;
+    }
+    else{
+      file = files->erase (file);
+    }
+  }
+  if (files->isEmpty ()) {
+    unitFiles_.erase (files);
+  }
 }
 
 void QtcCppcheckPlugin::clearTasksForFiles (const QStringList &fileList) {
   if (fileList.isEmpty ()) {
     TaskHub::clearTasks (Constants::TASK_CATEGORY_ID);
-    fileTasks_.clear ();
+    findings_.clear ();
+    unitFiles_.clear ();
+    checkers_.clear ();
+    messages_.clear ();
   }
   else{
     foreach (const QString &file, fileList) {
-      if (!fileTasks_.contains (file)) {
+      const int handle = paths_.find (file);
+      if (handle == -1) {
         continue;
       }
       Task task;
-      foreach (const TaskInfo &info, fileTasks_.values (file)) {
+      foreach (const TaskInfo &info, findings_.takeFile (handle)) {
         info.init (task);
         TaskHub::removeTask (task);
       }
-      fileTasks_.remove (file);
+      unitFiles_.remove (handle); // Removed files do not report tasks.
     }
   }
 }
@@ -456,4 +831,41 @@ void QtcCppcheckPlugin::clearTasksForFiles (const QStringList &fileList) {
 void QtcCppcheckPlugin::updateSettings () {
   Q_ASSERT (runner_ != NULL);
   runner_->updateSettings ();
+  // All patterns in one expression to match each file once.
+  QStringList expressions;
+  for (const auto &pattern: settings_->ignorePatterns ()) {
+    if (pattern.isEmpty ()) {
+      continue;
+    }
+    // Invalid one would disable all patterns in joined expression.
+    const QString expression = wildcardExpression (pattern);
+    if (!QRegularExpression (expression).isValid ()) {
+      MessageManager::write (tr ("Cppcheck: ignore pattern %1 is invalid and skipped")
+                             .arg (pattern), MessageManager::Silent);
+      continue;
+    }
+    expressions << expression;
+  }
+  ignoreExpression_ = QRegularExpression ();
+  if (!expressions.isEmpty ()) {
+    ignoreExpression_.setPattern (QLatin1String ("\\A(?:") +
+                                  expressions.join (QLatin1Char ('|')) + QLatin1String (")\\z"));
+    ignoreExpression_.optimize ();
+  }
+
+  QStringList directories;
+  for (const auto &directory: settings_->vendorDirectories ()) {
+    directories << QRegularExpression::escape (directory);
+  }
+  vendorExpression_ = QRegularExpression ();
+  if (settings_->skipExternal () && !directories.isEmpty ()) {
+    // Directory component of relative path.
+    vendorExpression_.setPattern (QLatin1String ("(?:^|/)(?:") +
+                                  directories.join (QLatin1Char ('|')) + QLatin1String (")/"));
+    vendorExpression_.setPatternOptions (QRegularExpression::CaseInsensitiveOption);
+    vendorExpression_.optimize ();
+  }
+  // Rules of checkable files changed so project is listed again before next check.
+  listedProject_.clear ();
+  isProjectListOutdated_ = projectFilesWatcher_.isRunning ();
 }
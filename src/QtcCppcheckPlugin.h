@@ -4,9 +4,20 @@
 #include <QModelIndex>
 #include <QStringList>
 #include <QPointer>
+#include <QRegularExpression>
+#include <QFutureWatcher>
+
+#include <functional>
+#include <QSet>
 
 #include <extensionsystem/iplugin.h>
 
+#include <cpptools/projectinfo.h>
+
+#include "FindingStore.h"
+#include "StringTable.h"
+#include "PathTable.h"
+
 namespace ProjectExplorer {
   class Project;
   class Task;
@@ -21,7 +32,7 @@ namespace QtcCppcheck {
 
     class Settings;
     class CppcheckRunner;
-    class TaskInfo;
+    struct Diagnostic;
 
     /*!
      * \brief main plugin class.
@@ -66,15 +77,39 @@ namespace QtcCppcheck {
         void handleSessionUnload ();
 
         // Task handling.
-        //! Add task to ProjectExplorer's task lits.
-        void addTask (char type, const QString &, const QString &description,
-                      const QString &fileName, int line);
+        //! Replace tasks of given checked files with new ones. Tasks found again are kept.
+        //! Diagnostics of other checked files are added to existing tasks.
+        void commitTasks (const QStringList &files, const QList<Diagnostic> &diagnostics);
+        //! Add task of existing file if it is not added yet. Returns true if added.
+        //! Adds task to reported ones of its checked file (keys are path handles).
+        bool addTask (const Diagnostic &diagnostic, bool showId,
+                      QHash<int, QSet<TaskInfo> > &reported);
+        //! Remove tasks that given checked file does not report anymore.
+        void removeUnitTasks (int unit, const QSet<TaskInfo> &reported);
+        //! Full description of task to show.
+        QString taskDescription (const TaskInfo &info) const;
         //! Clear self tasks for given files. All tasks if list is empty.
         void clearTasksForFiles (const QStringList &fileList = QStringList ());
 
         //! Apply updated settings data.
         void updateSettings ();
 
+      private:
+        //! Rules to skip generated and third-party files. Copied to background listing.
+        struct ExternalFilter {
+          ExternalFilter () : isEnabled (false) {}
+          //! File is generated (by name or location) or third-party one.
+          bool matches (const QString &name) const;
+
+          bool isEnabled;
+          //! Build directory with trailing slash. Empty if it contains sources.
+          QString buildDirectory;
+          //! Project directory with trailing slash.
+          QString projectDirectory;
+          //! Matches paths within third-party directories (relative to project directory).
+          QRegularExpression vendorExpression;
+        };
+
       private:
         void initMenus ();
         void initConnections ();
@@ -82,27 +117,96 @@ namespace QtcCppcheck {
 
         //! Get checkable files for given node.
         QStringList checkableFiles (const ProjectExplorer::Node *node, bool forceSelected = false) const;
+        void collectCheckableFiles (const ProjectExplorer::Node *node, bool forceSelected,
+                                    const ExternalFilter &filter, QStringList &files) const;
+        //! Filter of generated and third-party files of project.
+        ExternalFilter externalFilter (const ProjectExplorer::Project *project) const;
 
+        //! Start listing of active project's files in background.
+        //! Previous list is used until new one is ready.
         void updateProjectFileList ();
+        //! Take listed project's files.
+        void handleProjectFileListUpdated ();
+        //! Run action when file list of active project is ready.
+        void whenProjectListed (const std::function<void ()> &action);
+        //! All files of node. Files marked as generated are added to generatedFiles instead.
+        static void collectFiles (const ProjectExplorer::Node *node, QStringList &files,
+                                  QStringList &generatedFiles);
 
         //! Check given ProjectExplorer::Node.
         void checkNode (const ProjectExplorer::Node *node);
-        //! Check given files. Terminate current check if forced is true.
-        void checkFiles (const QStringList &fileNames);
+        //! Check given files. Interactive checks show first results faster.
+        void checkFiles (const QStringList &fileNames, bool isInteractive);
         //! Check active project's open documents within given range with given modified flag.
         void checkActiveProjectDocuments (int beginRow, int endRow, bool modifiedFlag);
+        //! Replace headers by project's sources that include them.
+        //! Recently used sources first, at most Settings::dependentsLimit () per header.
+        QStringList withDependents (const QStringList &files) const;
+
+      private:
+        //! Result of project files listing.
+        struct ProjectFiles {
+          //! Checkable files.
+          QStringList files;
+          //! Checkable files skipped as generated or third-party ones.
+          QStringList skippedFiles;
+          QStringList includePaths;
+          CppTools::ProjectInfo info;
+          QString projectPath;
+        };
+
+        //! Select checkable files and include paths of project. Runs in background.
+        static void enumerateProjectFiles (QFutureInterface<ProjectFiles> &futureInterface,
+                                           const QStringList &files,
+                                           const QStringList &generatedFiles,
+                                           const QRegularExpression &ignoreExpression,
+                                           const ExternalFilter &externalFilter,
+                                           const CppTools::ProjectInfo &info,
+                                           const QString &projectPath);
 
       private:
-        //! Project's file names (keys) and their task infos (values).
-        QHash<QString, TaskInfo> fileTasks_;
+        //! Added tasks by project's file names.
+        FindingStore findings_;
+        //! Checked files (keys) and files of their tasks (values) as path handles.
+        QHash<int, QSet<int> > unitFiles_;
+        //! Files of tasks, checked and project files. Shared with runner_
+        //! so it is never cleared.
+        PathTable paths_;
+        //! Checker ids of tasks.
+        StringTable checkers_;
+        //! Task messages with CWE and other locations (many tasks share them).
+        StringTable messages_;
         //! Settings.
         Settings *settings_;
         //! Binary runner.
         CppcheckRunner *runner_;
-        //! Checkable files list of active project.
-        QStringList projectFileList_;
+        //! Ignore patterns of settings. Empty if there are none.
+        QRegularExpression ignoreExpression_;
+        //! Third-party directories of settings. Empty if they are not skipped.
+        QRegularExpression vendorExpression_;
+        //! Number of skipped files of last reported project list.
+        int skippedFileCount_;
+        //! Checkable files list of active project as path handles.
+        QVector<int> projectFiles_;
+        //! Same files for fast search.
+        QSet<int> projectFileSet_;
         //! Pointer to active project.
         QPointer<ProjectExplorer::Project> activeProject_;
+        //! Project of projectFiles_.
+        QPointer<ProjectExplorer::Project> listedProject_;
+        //! Background listing of project's files.
+        QFutureWatcher<ProjectFiles> projectFilesWatcher_;
+        //! Project being listed.
+        QPointer<ProjectExplorer::Project> projectFilesProject_;
+        //! Added and removed files should be handled after listing.
+        bool hasProjectListChanges_;
+        //! Project was changed while listing.
+        bool isProjectListOutdated_;
+        //! Actions that wait for project's file list.
+        QList<std::function<void ()> > projectListedActions_;
+        //! Last activation order of documents (bigger is more recent).
+        QHash<QString, int> documentUsage_;
+        int usageCounter_;
     };
 
   } // namespace Internal
@@ -0,0 +1,346 @@
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+#include <algorithm>
+#include <cstring>
+
+#include "ResultCache.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  const quint32 storeVersion = 1;
+  const quint32 entryVersion = 1;
+  //! Forget contents info of files when store becomes bigger.
+  const int maxStoreSize = 200000;
+  const QString indexFileName = QLatin1String ("index.dat");
+
+  //! Include directives of source text.
+  QStringList scanIncludes (const QByteArray &text) {
+    QStringList includes;
+    const char *data = text.constData ();
+    const char *end = data + text.size ();
+    for (const char *line = data; line < end; ) {
+      const char *lineEnd = static_cast<const char *>(memchr (line, '\n', size_t (end - line)));
+      if (lineEnd == NULL) {
+        lineEnd = end;
+      }
+      const char *i = line;
+      while (i < lineEnd && (*i == ' ' || *i == '\t')) {
+        ++i;
+      }
+      if (i < lineEnd && *i == '#') {
+        ++i;
+        while (i < lineEnd && (*i == ' ' || *i == '\t')) {
+          ++i;
+        }
+        if (lineEnd - i > 7 && qstrncmp (i, "include", 7) == 0) {
+          i += 7;
+          while (i < lineEnd && (*i == ' ' || *i == '\t')) {
+            ++i;
+          }
+          if (i < lineEnd && (*i == '"' || *i == '<')) {
+            const char close = (*i == '"') ? '"' : '>';
+            const char *nameEnd = static_cast<const char *>(memchr (i + 1, close,
+                                                                    size_t (lineEnd - i - 1)));
+            if (nameEnd != NULL && nameEnd > i + 1) {
+              includes << QString::fromUtf8 (i, int (nameEnd - i));
+            }
+          }
+        }
+      }
+      line = lineEnd + 1;
+    }
+    return includes;
+  }
+
+  void writeDiagnostics (QDataStream &stream, const QList<Diagnostic> &diagnostics) {
+    stream << qint32 (diagnostics.size ());
+    for (const auto &diagnostic: diagnostics) {
+      stream << diagnostic.id << diagnostic.severity << diagnostic.message
+             << diagnostic.verboseMessage << qint32 (diagnostic.cwe) << diagnostic.isInconclusive
+             << diagnostic.checkedFile << qint32 (diagnostic.locations.size ());
+      for (const auto &location: diagnostic.locations) {
+        stream << location.file << qint32 (location.line) << qint32 (location.column)
+               << location.info;
+      }
+    }
+  }
+
+  bool readDiagnostics (QDataStream &stream, QList<Diagnostic> &diagnostics) {
+    qint32 count = 0;
+    stream >> count;
+    diagnostics.clear ();
+    diagnostics.reserve (count);
+    for (qint32 i = 0; i < count && stream.status () == QDataStream::Ok; ++i) {
+      Diagnostic diagnostic;
+      qint32 cwe = 0;
+      qint32 locationCount = 0;
+      stream >> diagnostic.id >> diagnostic.severity >> diagnostic.message
+      >> diagnostic.verboseMessage >> cwe >> diagnostic.isInconclusive
+      >> diagnostic.checkedFile >> locationCount;
+      diagnostic.cwe = cwe;
+      for (qint32 j = 0; j < locationCount && stream.status () == QDataStream::Ok; ++j) {
+        DiagnosticLocation location;
+        qint32 line = 0;
+        qint32 column = 0;
+        stream >> location.file >> line >> column >> location.info;
+        location.line = line;
+        location.column = column;
+        diagnostic.locations << location;
+      }
+      diagnostics << diagnostic;
+    }
+    return stream.status () == QDataStream::Ok;
+  }
+}
+
+ResultCache::ResultCache (const QString &directory) :
+  directory_ (directory), totalSize_ (0), isModified_ (false) {
+}
+
+ResultCache::~ResultCache () {
+  save ();
+}
+
+void ResultCache::forgetStates () {
+  checkedFiles_.clear ();
+  resolvedIncludes_.clear ();
+}
+
+void ResultCache::forgetState (const QString &fileName) {
+  checkedFiles_.remove (fileName);
+}
+
+const ResultCache::FileState *ResultCache::fileState (const QString &fileName) {
+  auto state = files_.find (fileName);
+  if (checkedFiles_.contains (fileName)) {
+    return (state != files_.end ()) ? &state.value () : NULL;
+  }
+  checkedFiles_.insert (fileName);
+  const QFileInfo info (fileName);
+  if (!info.isFile ()) {
+    if (state != files_.end ()) {
+      files_.erase (state);
+      isModified_ = true;
+    }
+    return NULL;
+  }
+  const qint64 modified = info.lastModified ().toMSecsSinceEpoch ();
+  if (state != files_.end () && state->size == info.size () && state->modified == modified) {
+    return &state.value ();
+  }
+  QFile file (fileName);
+  if (!file.open (QIODevice::ReadOnly)) {
+    if (state != files_.end ()) {
+      files_.erase (state);
+      isModified_ = true;
+    }
+    return NULL;
+  }
+  const QByteArray contents = file.readAll ();
+  FileState &newState = files_[fileName];
+  newState.size = info.size ();
+  newState.modified = modified;
+  newState.hash = QCryptographicHash::hash (contents, QCryptographicHash::Md5);
+  newState.includes = scanIncludes (contents);
+  isModified_ = true;
+  return &newState;
+}
+
+QString ResultCache::resolveInclude (const QString &includer, const QString &include,
+                                     const QStringList &includePaths,
+                                     const QString &includePathsKey) {
+  const bool isQuoted = include.startsWith (QLatin1Char ('"'));
+  const QString directory = isQuoted ? includer.left (includer.lastIndexOf (QLatin1Char ('/')))
+                            : QString ();
+  const QString name = include.mid (1);
+  const QString cacheKey = directory + QLatin1Char ('\n') + include + QLatin1Char ('\n') +
+                           includePathsKey;
+  auto resolved = resolvedIncludes_.constFind (cacheKey);
+  if (resolved != resolvedIncludes_.constEnd ()) {
+    return resolved.value ();
+  }
+  QString path;
+  if (isQuoted && QFileInfo (directory + QLatin1Char ('/') + name).isFile ()) {
+    path = QDir::cleanPath (directory + QLatin1Char ('/') + name);
+  }
+  for (int i = 0, end = includePaths.size (); i < end && path.isEmpty (); ++i) {
+    const QString candidate = includePaths.at (i) + QLatin1Char ('/') + name;
+    if (QFileInfo (candidate).isFile ()) {
+      path = QDir::cleanPath (candidate);
+    }
+  }
+  resolvedIncludes_.insert (cacheKey, path);
+  return path;
+}
+
+QByteArray ResultCache::key (const QString &fileName, const QString &arguments,
+                             const QStringList &includePaths) {
+  if (fileState (fileName) == NULL) {
+    return QByteArray ();
+  }
+  // Include closure. Conditional includes are counted too.
+  const QString includePathsKey = includePaths.join (QLatin1Char ('\n'));
+  QStringList closure {fileName};
+  QSet<QString> visited {fileName};
+  for (int i = 0; i < closure.size (); ++i) {
+    const QString file = closure.at (i);
+    const FileState *state = fileState (file);
+    if (state == NULL) {
+      continue;
+    }
+    for (const auto &include: state->includes) {
+      const QString path = resolveInclude (file, include, includePaths, includePathsKey);
+      if (!path.isEmpty () && !visited.contains (path)) {
+        visited.insert (path);
+        closure << path;
+      }
+    }
+  }
+  std::sort (closure.begin () + 1, closure.end ());
+
+  QCryptographicHash hash (QCryptographicHash::Md5);
+  hash.addData (arguments.toUtf8 ());
+  for (const auto &file: closure) {
+    const FileState *state = fileState (file);
+    hash.addData (file.toUtf8 ());
+    hash.addData (state != NULL ? state->hash : QByteArray ());
+  }
+  return hash.result ();
+}
+
+QString ResultCache::entryFileName (const QByteArray &key) const {
+  return directory_ + QLatin1Char ('/') + QString::fromLatin1 (key.toHex ());
+}
+
+bool ResultCache::find (const QByteArray &key, QList<Diagnostic> &diagnostics) {
+  auto entry = entries_.find (key);
+  if (entry == entries_.end ()) {
+    return false;
+  }
+  QFile file (entryFileName (key));
+  if (file.open (QIODevice::ReadOnly)) {
+    QDataStream stream (&file);
+    quint32 version = 0;
+    stream >> version;
+    if (version == entryVersion && readDiagnostics (stream, diagnostics)) {
+      entry->lastUsed = QDateTime::currentMSecsSinceEpoch ();
+      isModified_ = true;
+      return true;
+    }
+  }
+  totalSize_ -= entry->size;
+  entries_.erase (entry);
+  file.remove ();
+  isModified_ = true;
+  return false;
+}
+
+void ResultCache::insert (const QByteArray &key, const QList<Diagnostic> &diagnostics) {
+  if (key.isEmpty ()) {
+    return;
+  }
+  QDir ().mkpath (directory_);
+  QFile file (entryFileName (key));
+  if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return;
+  }
+  QDataStream stream (&file);
+  stream << entryVersion;
+  writeDiagnostics (stream, diagnostics);
+  Entry &entry = entries_[key];
+  totalSize_ += file.size () - entry.size;
+  entry.size = file.size ();
+  entry.lastUsed = QDateTime::currentMSecsSinceEpoch ();
+  isModified_ = true;
+}
+
+void ResultCache::limitSize (qint64 maxSize) {
+  if (totalSize_ <= maxSize) {
+    return;
+  }
+  QList<QPair<qint64, QByteArray> > ages;
+  ages.reserve (entries_.size ());
+  for (auto i = entries_.constBegin (), end = entries_.constEnd (); i != end; ++i) {
+    ages.append (qMakePair (i->lastUsed, i.key ()));
+  }
+  std::sort (ages.begin (), ages.end ());
+  for (const auto &i: ages) {
+    if (totalSize_ <= maxSize) {
+      break;
+    }
+    QFile::remove (entryFileName (i.second));
+    totalSize_ -= entries_.take (i.second).size;
+  }
+  isModified_ = true;
+}
+
+qint64 ResultCache::size () const {
+  return totalSize_;
+}
+
+void ResultCache::load () {
+  files_.clear ();
+  entries_.clear ();
+  totalSize_ = 0;
+  QFile file (directory_ + QLatin1Char ('/') + indexFileName);
+  if (file.open (QIODevice::ReadOnly)) {
+    QDataStream stream (&file);
+    quint32 version = 0;
+    qint32 count = 0;
+    stream >> version;
+    if (version == storeVersion) {
+      stream >> count;
+      for (qint32 i = 0; i < count && stream.status () == QDataStream::Ok; ++i) {
+        QByteArray key;
+        Entry entry;
+        stream >> key >> entry.size >> entry.lastUsed;
+        entries_.insert (key, entry);
+        totalSize_ += entry.size;
+      }
+      stream >> count;
+      for (qint32 i = 0; i < count && stream.status () == QDataStream::Ok; ++i) {
+        QString name;
+        FileState state;
+        stream >> name >> state.size >> state.modified >> state.hash >> state.includes;
+        files_.insert (name, state);
+      }
+      if (stream.status () != QDataStream::Ok) {
+        files_.clear ();
+        entries_.clear ();
+        totalSize_ = 0;
+      }
+    }
+  }
+  isModified_ = false;
+}
+
+void ResultCache::save () {
+  if (!isModified_) {
+    return;
+  }
+  if (files_.size () > maxStoreSize) {
+    files_.clear ();
+    checkedFiles_.clear ();
+  }
+  QDir ().mkpath (directory_);
+  QFile file (directory_ + QLatin1Char ('/') + indexFileName);
+  if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return;
+  }
+  QDataStream stream (&file);
+  stream << storeVersion << qint32 (entries_.size ());
+  for (auto i = entries_.constBegin (), end = entries_.constEnd (); i != end; ++i) {
+    stream << i.key () << i->size << i->lastUsed;
+  }
+  stream << qint32 (files_.size ());
+  for (auto i = files_.constBegin (), end = files_.constEnd (); i != end; ++i) {
+    stream << i.key () << i->size << i->modified << i->hash << i->includes;
+  }
+  isModified_ = false;
+}
@@ -0,0 +1,93 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+#include "Diagnostic.h"
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Persistent check results of files.
+     * Results are keyed by contents of file and of all files it includes
+     * (found by scanning #include directives) and by arguments of check,
+     * so unchanged files are not checked again even in other sessions.
+     * Contents are hashed only if file's size or modification time changed.
+     * Checked states are kept until forgetStates () so each file is checked once
+     * per session.
+     * Least recently used results are removed when cache becomes too big.
+     * Not thread safe, reads and writes files so should be used in background.
+     * Stored results are available after load ().
+     */
+    class ResultCache {
+      public:
+        explicit ResultCache (const QString &directory);
+        ~ResultCache ();
+
+        //! Forget checked modification times (files may be changed since).
+        void forgetStates ();
+        //! Forget checked modification time of given file.
+        void forgetState (const QString &fileName);
+        //! Key of file's results. Arguments must contain everything else that affects
+        //! results (binary version, flags). Include paths are used to find included files.
+        //! Empty if file can't be read.
+        QByteArray key (const QString &fileName, const QString &arguments,
+                        const QStringList &includePaths);
+        //! Get results by key. Returns false if there are none.
+        bool find (const QByteArray &key, QList<Diagnostic> &diagnostics);
+        void insert (const QByteArray &key, const QList<Diagnostic> &diagnostics);
+        //! Remove least recently used results while summary size exceeds given one.
+        void limitSize (qint64 maxSize);
+        //! Summary size of stored results.
+        qint64 size () const;
+
+        void load ();
+        void save ();
+
+      private:
+        //! File contents info.
+        struct FileState {
+          FileState () : size (-1), modified (-1) {}
+          qint64 size;
+          qint64 modified;
+          QByteArray hash;
+          //! Include directives ("\"name" for quoted, "<name" for angle ones).
+          QStringList includes;
+        };
+        //! Stored results info.
+        struct Entry {
+          Entry () : size (0), lastUsed (0) {}
+          qint64 size;
+          qint64 lastUsed;
+        };
+
+        //! Actual state of file. NULL if file can't be read.
+        const FileState *fileState (const QString &fileName);
+        //! Included file path or empty string if not found.
+        //! Include paths key is joined include paths.
+        QString resolveInclude (const QString &includer, const QString &include,
+                                const QStringList &includePaths, const QString &includePathsKey);
+        QString entryFileName (const QByteArray &key) const;
+
+      private:
+        QString directory_;
+        //! Contents info by file name.
+        QHash<QString, FileState> files_;
+        //! Files which state is checked since forgetStates ().
+        QSet<QString> checkedFiles_;
+        //! Resolved includes since forgetStates ().
+        QHash<QString, QString> resolvedIncludes_;
+        //! Stored results by key.
+        QHash<QByteArray, Entry> entries_;
+        //! Summary size of stored results.
+        qint64 totalSize_;
+        bool isModified_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // RESULTCACHE_H
@@ -1,5 +1,6 @@
 #include <QString>
 #include <QFile>
+#include <QStandardPaths>
 
 #include <utils/hostosinfo.h>
 #include <utils/fileutils.h>
@@ -24,6 +25,11 @@ namespace {
     }
     return QFile::exists (res) ? res : QString ();
   }
+
+  QStringList defaultVendorDirectories () {
+    return QStringList () << QLatin1String ("3rdparty") << QLatin1String ("third_party")
+                          << QLatin1String ("thirdparty") << QLatin1String ("vendor");
+  }
 }
 
 Settings::Settings (bool autoLoad) :
@@ -33,7 +39,9 @@ Settings::Settings (bool autoLoad) :
   ignoreIncludePaths_ (false),
   showBinaryOutput_ (false),
   showId_ (false),
-  popupOnError_ (false), popupOnWarning_ (false) {
+  popupOnError_ (false), popupOnWarning_ (false),
+  incrementalCheck_ (true), cacheSizeLimit_ (1024), dependentsLimit_ (20),
+  skipExternal_ (true), vendorDirectories_ (defaultVendorDirectories ()) {
   if (autoLoad) {
     load ();
   }
@@ -57,6 +65,11 @@ void Settings::save () {
   settings.setValue (QLatin1String (SETTINGS_SHOW_ID), showId_);
   settings.setValue (QLatin1String (SETTINGS_POPUP_ON_ERROR), popupOnError_);
   settings.setValue (QLatin1String (SETTINGS_POPUP_ON_WARNING), popupOnWarning_);
+  settings.setValue (QLatin1String (SETTINGS_INCREMENTAL_CHECK), incrementalCheck_);
+  settings.setValue (QLatin1String (SETTINGS_CACHE_SIZE_LIMIT), cacheSizeLimit_);
+  settings.setValue (QLatin1String (SETTINGS_DEPENDENTS_LIMIT), dependentsLimit_);
+  settings.setValue (QLatin1String (SETTINGS_SKIP_EXTERNAL), skipExternal_);
+  settings.setValue (QLatin1String (SETTINGS_VENDOR_DIRECTORIES), vendorDirectories_.join (","));
   settings.endGroup ();
 }
 
@@ -92,12 +105,28 @@ void Settings::load () {
                                   true).toBool ();
   popupOnWarning_ = settings.value (QLatin1String (SETTINGS_POPUP_ON_WARNING),
                                     true).toBool ();
+  incrementalCheck_ = settings.value (QLatin1String (SETTINGS_INCREMENTAL_CHECK),
+                                      true).toBool ();
+  cacheSizeLimit_ = settings.value (QLatin1String (SETTINGS_CACHE_SIZE_LIMIT),
+                                    1024).toInt ();
+  dependentsLimit_ = settings.value (QLatin1String (SETTINGS_DEPENDENTS_LIMIT),
+                                     20).toInt ();
+  skipExternal_ = settings.value (QLatin1String (SETTINGS_SKIP_EXTERNAL),
+                                  true).toBool ();
+  vendorDirectories_ = settings.value (QLatin1String (SETTINGS_VENDOR_DIRECTORIES),
+                                       defaultVendorDirectories ().join (","))
+                       .toString ().split (",", QString::SkipEmptyParts);
   settings.endGroup ();
   if (binaryFile_.isEmpty ()) {
     binaryFile_ = defaultBinary ();
   }
 }
 
+QString Settings::cacheDirectory () {
+  return QStandardPaths::writableLocation (QStandardPaths::CacheLocation) +
+         QLatin1String ("/QtcCppcheck");
+}
+
 QString Settings::binaryFile () const {
   return binaryFile_;
 }
@@ -211,3 +240,48 @@ bool Settings::checkOnSave () const {
 void Settings::setCheckOnSave (bool checkOnSave) {
   checkOnSave_ = checkOnSave;
 }
+
+bool Settings::incrementalCheck () const {
+  return incrementalCheck_;
+}
+
+void Settings::setIncrementalCheck (bool incrementalCheck) {
+  incrementalCheck_ = incrementalCheck;
+}
+
+int Settings::cacheSizeLimit () const {
+  return cacheSizeLimit_;
+}
+
+void Settings::setCacheSizeLimit (int cacheSizeLimit) {
+  cacheSizeLimit_ = cacheSizeLimit;
+}
+
+int Settings::dependentsLimit () const {
+  return dependentsLimit_;
+}
+
+void Settings::setDependentsLimit (int dependentsLimit) {
+  dependentsLimit_ = dependentsLimit;
+}
+
+bool Settings::skipExternal () const {
+  return skipExternal_;
+}
+
+void Settings::setSkipExternal (bool skipExternal) {
+  skipExternal_ = skipExternal;
+}
+
+QStringList Settings::vendorDirectories () const {
+  return vendorDirectories_;
+}
+
+void Settings::setVendorDirectories (const QStringList &vendorDirectories) {
+  vendorDirectories_.clear ();
+  for (const auto &i: vendorDirectories) {
+    if (!i.trimmed ().isEmpty ()) {
+      vendorDirectories_ << i.trimmed ();
+    }
+  }
+}
@@ -18,6 +18,9 @@ namespace QtcCppcheck {
         void save ();
         void load ();
 
+        //! Directory to keep plugin's caches in.
+        static QString cacheDirectory ();
+
         QString binaryFile () const;
         void setBinaryFile (const QString &binaryFile);
 
@@ -60,6 +63,25 @@ namespace QtcCppcheck {
         bool ignoreIncludePaths () const;
         void setIgnoreIncludePaths (bool ignoreIncludePaths);
 
+        bool incrementalCheck () const;
+        void setIncrementalCheck (bool incrementalCheck);
+
+        //! In megabytes.
+        int cacheSizeLimit () const;
+        void setCacheSizeLimit (int cacheSizeLimit);
+
+        //! Max number of files that include saved header to check instead of it.
+        int dependentsLimit () const;
+        void setDependentsLimit (int dependentsLimit);
+
+        //! Do not check generated and third-party files of projects.
+        bool skipExternal () const;
+        void setSkipExternal (bool skipExternal);
+
+        //! Names of third-party directories.
+        QStringList vendorDirectories () const;
+        void setVendorDirectories (const QStringList &vendorDirectories);
+
       private:
         QString binaryFile_;
 
@@ -78,6 +100,12 @@ namespace QtcCppcheck {
 
         bool popupOnError_;
         bool popupOnWarning_;
+
+        bool incrementalCheck_;
+        int cacheSizeLimit_;
+        int dependentsLimit_;
+        bool skipExternal_;
+        QStringList vendorDirectories_;
     };
 
   } // namespace Internal
@@ -0,0 +1,59 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QAtomicPointer>
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Unbounded lock-free queue for single producer and single consumer threads.
+     * Head is a dummy node owned by consumer, tail is owned by producer.
+     */
+    template<typename T>
+    class SpscQueue {
+      public:
+        SpscQueue () : head_ (new Node), tail_ (head_) {}
+        ~SpscQueue () {
+          while (Node *node = head_) {
+            head_ = node->next.loadAcquire ();
+            delete node;
+          }
+        }
+
+        //! Add value. Producer side.
+        void push (const T &value) {
+          Node *node = new Node;
+          node->value = value;
+          tail_->next.storeRelease (node);
+          tail_ = node;
+        }
+        //! Take oldest value. Consumer side. Returns false if queue is empty.
+        bool pop (T &value) {
+          Node *next = head_->next.loadAcquire ();
+          if (next == NULL) {
+            return false;
+          }
+          value = next->value;
+          next->value = T (); // Next becomes dummy node.
+          delete head_;
+          head_ = next;
+          return true;
+        }
+
+      private:
+        Q_DISABLE_COPY (SpscQueue)
+
+        struct Node {
+          QAtomicPointer<Node> next;
+          T value;
+        };
+
+        Node *head_;
+        Node *tail_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,31 @@
+#include "StringTable.h"
+
+using namespace QtcCppcheck::Internal;
+
+int StringTable::intern (const QString &string) {
+  auto handle = handles_.constFind (string);
+  if (handle != handles_.constEnd ()) {
+    return handle.value ();
+  }
+  strings_.append (string);
+  handles_.insert (string, strings_.size () - 1);
+  return strings_.size () - 1;
+}
+
+int StringTable::find (const QString &string) const {
+  return handles_.value (string, -1);
+}
+
+const QString &StringTable::string (int handle) const {
+  Q_ASSERT (handle >= 0 && handle < strings_.size ());
+  return strings_.at (handle);
+}
+
+int StringTable::size () const {
+  return strings_.size ();
+}
+
+void StringTable::clear () {
+  handles_.clear ();
+  strings_.clear ();
+}
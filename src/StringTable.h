@@ -0,0 +1,34 @@
+#ifndef STRINGTABLE_H
+#define STRINGTABLE_H
+
+#include <QHash>
+#include <QVector>
+#include <QString>
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Interned strings referenced by integer handles.
+     * Equal strings get same handle and are stored once.
+     */
+    class StringTable {
+      public:
+        //! Handle of string. Adds string if it is new.
+        int intern (const QString &string);
+        //! Handle of string or -1 if it is not added.
+        int find (const QString &string) const;
+        //! String of valid handle.
+        const QString &string (int handle) const;
+        int size () const;
+        void clear ();
+
+      private:
+        QHash<QString, int> handles_;
+        QVector<QString> strings_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // STRINGTABLE_H
@@ -1,3 +1,5 @@
+#include <QHash>
+
 #include <projectexplorer/task.h>
 
 #include "TaskInfo.h"
@@ -6,17 +8,12 @@
 using namespace QtcCppcheck::Internal;
 
 TaskInfo::TaskInfo () :
-  id_ (-1), line_ (-1) {
+  id_ (-1), file_ (-1), line_ (-1), checker_ (-1), message_ (-1) {
 }
 
-TaskInfo::TaskInfo (uint line, const QString &description) :
-  id_ (-1), description_ (description), line_ (line) {
-
-}
+TaskInfo::TaskInfo (int file, int line, int checker, int message) :
+  id_ (-1), file_ (file), line_ (line), checker_ (checker), message_ (message) {
 
-TaskInfo::TaskInfo (const ProjectExplorer::Task &source) :
-  id_ (-1), line_ (-1) {
-  *this = source;
 }
 
 void TaskInfo::init (ProjectExplorer::Task &task) const {
@@ -25,15 +22,48 @@ void TaskInfo::init (ProjectExplorer::Task &task) const {
   task.category = Constants::TASK_CATEGORY_ID;
 }
 
-TaskInfo &TaskInfo::operator= (const ProjectExplorer::Task &right) {
-  id_ = right.taskId;
-  description_ = right.description;
-  line_ = right.line;
-  return (*this);
+bool TaskInfo::operator== (const TaskInfo &right) const {
+  return (message_ == right.message_ &&
+          line_ == right.line_ &&
+          checker_ == right.checker_ &&
+          file_ == right.file_);
+}
+
+uint TaskInfo::hash () const {
+  return ::qHash (message_, uint (line_)) ^ ::qHash (checker_, uint (file_));
 }
 
+int TaskInfo::file () const {
+  return file_;
+}
 
-bool TaskInfo::operator== (const TaskInfo &right) const {
-  return (description_ == right.description_ &&
-          line_ == right.line_);
+int TaskInfo::line () const {
+  return line_;
+}
+
+int TaskInfo::checker () const {
+  return checker_;
+}
+
+int TaskInfo::message () const {
+  return message_;
+}
+
+void TaskInfo::setId (uint id) {
+  id_ = id;
+}
+
+bool TaskInfo::hasUnit (int unit) const {
+  return units_.contains (unit);
+}
+
+void TaskInfo::addUnit (int unit) {
+  if (!units_.contains (unit)) {
+    units_.append (unit);
+  }
+}
+
+bool TaskInfo::removeUnit (int unit) {
+  units_.removeAll (unit);
+  return units_.isEmpty ();
 }
@@ -1,7 +1,7 @@
 #ifndef TASKINFO_H
 #define TASKINFO_H
 
-#include <QString>
+#include <QVector>
 
 namespace ProjectExplorer {
   class Task;
@@ -14,23 +14,49 @@ namespace QtcCppcheck {
      * \brief Task information holder.
      * Required to prevend addition of duplicate tasks in situations where
      * tasks found for non-checking files (checking cpp -> reported for header).
+     * Remembers checked files (units) that reported the task to remove it
+     * only when none of them reports it anymore.
+     * Strings are stored as handles of plugin's string tables, task's
+     * description is built only when it is added to TaskHub.
      */
     class TaskInfo {
       public:
         TaskInfo ();
-        TaskInfo (uint line, const QString &description);
-        TaskInfo (const ProjectExplorer::Task &source);
+        //! Checker is -1 if checker's id is not shown.
+        TaskInfo (int file, int line, int checker, int message);
 
         void init (ProjectExplorer::Task &task) const;
-        TaskInfo &operator= (const ProjectExplorer::Task &right);
+        //! Same finding (units and TaskHub's id are not compared).
         bool operator== (const TaskInfo &right) const;
+        //! Hash consistent with operator==.
+        uint hash () const;
+
+        int file () const;
+        int line () const;
+        int checker () const;
+        int message () const;
+        //! Set TaskHub's id of added task.
+        void setId (uint id);
+
+        bool hasUnit (int unit) const;
+        void addUnit (int unit);
+        //! Returns true if no units left.
+        bool removeUnit (int unit);
 
       private:
         uint id_;
-        QString description_;
+        int file_;
         int line_;
+        int checker_;
+        int message_;
+        //! Checked files that reported task.
+        QVector<int> units_;
     };
 
+    inline uint qHash (const TaskInfo &info) {
+      return info.hash ();
+    }
+
   } // namespace Internal
 } // namespace QtcCppcheck
 
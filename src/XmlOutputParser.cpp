@@ -0,0 +1,243 @@
+#include <QDir>
+
+#include <cstring>
+
+#include "XmlOutputParser.h"
+
+using namespace QtcCppcheck::Internal;
+
+namespace {
+  bool isSpace (char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+  }
+
+  //! Tag name at begin (after '<') equals to name.
+  bool isTag (const char *begin, const char *end, const char *name, int nameLength) {
+    if (end - begin < nameLength || std::memcmp (begin, name, nameLength) != 0) {
+      return false;
+    }
+    return (end - begin == nameLength || isSpace (begin[nameLength]) || begin[nameLength] == '/');
+  }
+
+  int toInt (const char *begin, const char *end) {
+    int result = 0;
+    for (; begin != end && *begin >= '0' && *begin <= '9'; ++begin) {
+      result = result * 10 + (*begin - '0');
+    }
+    return result;
+  }
+
+  //! Attribute value with decoded entities.
+  QString toString (const char *begin, const char *end) {
+    const char *amp = static_cast<const char *>(std::memchr (begin, '&', end - begin));
+    if (amp == NULL) {
+      return QString::fromUtf8 (begin, int (end - begin));
+    }
+    QByteArray decoded;
+    decoded.reserve (int (end - begin));
+    while (amp != NULL) {
+      decoded.append (begin, int (amp - begin));
+      const char *semicolon = static_cast<const char *>(std::memchr (amp, ';', end - amp));
+      if (semicolon == NULL) {
+        begin = amp;
+        break;
+      }
+      const QByteArray entity = QByteArray::fromRawData (amp + 1, int (semicolon - amp - 1));
+      if (entity == "quot") {
+        decoded.append ('"');
+      }
+      else if (entity == "amp") {
+        decoded.append ('&');
+      }
+      else if (entity == "lt") {
+        decoded.append ('<');
+      }
+      else if (entity == "gt") {
+        decoded.append ('>');
+      }
+      else if (entity == "apos") {
+        decoded.append ('\'');
+      }
+      else if (entity.startsWith ('#')) {
+        const bool isHex = entity.startsWith ("#x");
+        const uint code = entity.mid (isHex ? 2 : 1).toUInt (NULL, isHex ? 16 : 10);
+        decoded.append (QString::fromUcs4 (&code, 1).toUtf8 ());
+      }
+      begin = semicolon + 1;
+      amp = static_cast<const char *>(std::memchr (begin, '&', end - begin));
+    }
+    decoded.append (begin, int (end - begin));
+    return QString::fromUtf8 (decoded);
+  }
+
+  //! Calls handler with name and value bounds for each attribute of tag.
+  template<typename Handler>
+  void forEachAttribute (const char *begin, const char *end, Handler handler) {
+    for (;;) {
+      const char *equal = static_cast<const char *>(std::memchr (begin, '=', end - begin));
+      if (equal == NULL || equal + 1 >= end || equal[1] != '"') {
+        return;
+      }
+      const char *valueEnd = static_cast<const char *>(std::memchr (equal + 2, '"', end - equal - 2));
+      if (valueEnd == NULL) {
+        return;
+      }
+      const char *name = equal;
+      while (name > begin && !isSpace (name[-1])) {
+        --name;
+      }
+      handler (QByteArray::fromRawData (name, int (equal - name)), equal + 2, valueEnd);
+      begin = valueEnd + 1;
+    }
+  }
+}
+
+XmlOutputParser::XmlOutputParser () :
+  position_ (0), isInError_ (false) {
+}
+
+void XmlOutputParser::reset () {
+  buffer_.clear ();
+  position_ = 0;
+  current_ = Diagnostic ();
+  isInError_ = false;
+}
+
+void XmlOutputParser::addData (const QByteArray &data) {
+  // Drop parsed data only when it takes most of buffer.
+  if (position_ > 0 && position_ >= buffer_.size () / 2) {
+    buffer_.remove (0, position_);
+    position_ = 0;
+  }
+  if (buffer_.isEmpty ()) {
+    buffer_ = data;
+  }
+  else{
+    buffer_.append (data);
+  }
+}
+
+bool XmlOutputParser::readNext (Diagnostic &diagnostic) {
+  const char *data = buffer_.constData ();
+  const int size = buffer_.size ();
+  while (position_ < size) {
+    const char *tagStart = static_cast<const char *>(std::memchr (data + position_, '<',
+                                                                  size - position_));
+    if (tagStart == NULL) {
+      position_ = size;
+      break;
+    }
+    const int end = tagEnd (int (tagStart - data));
+    if (end == -1) {
+      position_ = int (tagStart - data);
+      break;
+    }
+    position_ = end + 1;
+
+    const char *nameBegin = tagStart + 1;
+    const char *contentEnd = data + end;
+    const bool isEmpty = (contentEnd > nameBegin && contentEnd[-1] == '/');
+    if (isTag (nameBegin, contentEnd, "error", 5)) {
+      readError (nameBegin, contentEnd);
+      if (!isEmpty) {
+        continue;
+      }
+    }
+    else if (isInError_ && isTag (nameBegin, contentEnd, "location", 8)) {
+      readLocation (nameBegin, contentEnd);
+      continue;
+    }
+    else if (!isInError_ || !isTag (nameBegin, contentEnd, "/error", 6)) {
+      continue;
+    }
+    isInError_ = false;
+    if (current_.checkedFile.isEmpty ()) {
+      current_.checkedFile = current_.file ();
+    }
+    diagnostic = current_;
+    current_ = Diagnostic ();
+    return true;
+  }
+  return false;
+}
+
+int XmlOutputParser::tagEnd (int tagStart) const {
+  const char *data = buffer_.constData ();
+  const char *end = data + buffer_.size ();
+  const char *i = data + tagStart;
+  for (;;) {
+    const char *close = static_cast<const char *>(std::memchr (i, '>', end - i));
+    if (close == NULL) {
+      return -1;
+    }
+    const char *quote = static_cast<const char *>(std::memchr (i, '"', close - i));
+    if (quote == NULL) {
+      return int (close - data);
+    }
+    const char *quoteEnd = static_cast<const char *>(std::memchr (quote + 1, '"', end - quote - 1));
+    if (quoteEnd == NULL) {
+      return -1;
+    }
+    i = quoteEnd + 1;
+  }
+}
+
+void XmlOutputParser::readError (const char *begin, const char *end) {
+  current_ = Diagnostic ();
+  forEachAttribute (begin, end, [this] (const QByteArray &name, const char *value,
+                                        const char *valueEnd) {
+    if (name == "id") {
+      current_.id = toString (value, valueEnd);
+    }
+    else if (name == "severity") {
+      current_.severity = toString (value, valueEnd);
+    }
+    else if (name == "msg") {
+      current_.message = toString (value, valueEnd);
+    }
+    else if (name == "verbose") {
+      current_.verboseMessage = toString (value, valueEnd);
+    }
+    else if (name == "cwe") {
+      current_.cwe = toInt (value, valueEnd);
+    }
+    else if (name == "file0") { // Only if differs from main location.
+      current_.checkedFile = path (value, valueEnd);
+    }
+    else if (name == "inconclusive") {
+      current_.isInconclusive = (valueEnd - value == 4 && std::memcmp (value, "true", 4) == 0);
+    }
+  });
+  isInError_ = true;
+}
+
+void XmlOutputParser::readLocation (const char *begin, const char *end) {
+  DiagnosticLocation location;
+  forEachAttribute (begin, end, [this, &location] (const QByteArray &name, const char *value,
+                                                   const char *valueEnd) {
+    if (name == "file") {
+      location.file = path (value, valueEnd);
+    }
+    else if (name == "line") {
+      location.line = toInt (value, valueEnd);
+    }
+    else if (name == "column") {
+      location.column = toInt (value, valueEnd);
+    }
+    else if (name == "info") {
+      location.info = toString (value, valueEnd);
+    }
+  });
+  current_.locations.append (location);
+}
+
+QString XmlOutputParser::path (const char *begin, const char *end) {
+  const QByteArray raw = QByteArray::fromRawData (begin, int (end - begin));
+  auto it = paths_.constFind (raw);
+  if (it != paths_.constEnd ()) {
+    return it.value ();
+  }
+  const QString decoded = QDir::fromNativeSeparators (toString (begin, end));
+  paths_.insert (QByteArray (begin, int (end - begin)), decoded);
+  return decoded;
+}
@@ -0,0 +1,52 @@
+#ifndef XMLOUTPUTPARSER_H
+#define XMLOUTPUTPARSER_H
+
+#include <QByteArray>
+#include <QHash>
+
+#include "Diagnostic.h"
+
+namespace QtcCppcheck {
+  namespace Internal {
+
+    /*!
+     * \brief Incremental parser of cppcheck's --xml-version=2 output.
+     * Accepts output chunks as they arrive, returns each diagnostic
+     * when its closing tag is read.
+     * Scans raw bytes in place (output's structure is fixed and simple)
+     * and decodes only used attributes. File paths are decoded once.
+     */
+    class XmlOutputParser {
+      public:
+        XmlOutputParser ();
+
+        //! Prepare for new process' output.
+        void reset ();
+        void addData (const QByteArray &data);
+        //! Read next complete diagnostic. Returns false if more data is required.
+        bool readNext (Diagnostic &diagnostic);
+
+      private:
+        //! Index of tag's closing '>' (not in attribute value) or -1 if not received yet.
+        int tagEnd (int tagStart) const;
+        void readError (const char *begin, const char *end);
+        void readLocation (const char *begin, const char *end);
+        //! Decoded file path, shared by all its diagnostics.
+        QString path (const char *begin, const char *end);
+
+      private:
+        //! Received, not parsed yet data starts at position_.
+        QByteArray buffer_;
+        int position_;
+        //! Diagnostic being read.
+        Diagnostic current_;
+        //! Inside of <error> element.
+        bool isInError_;
+        //! Decoded paths by raw ones.
+        QHash<QByteArray, QString> paths_;
+    };
+
+  } // namespace Internal
+} // namespace QtcCppcheck
+
+#endif // XMLOUTPUTPARSER_H
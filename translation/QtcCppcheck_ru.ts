@@ -47,7 +47,7 @@
         <translation>Проверять при смене активного проекта</translation>
     </message>
     <message>
-        <location filename="../src/OptionsWidget.ui" line="182"/>
+        <location filename="../src/OptionsWidget.ui" line="240"/>
         <source>Check added files</source>
         <translation>Проверять добавленные файлы</translation>
     </message>
@@ -82,12 +82,12 @@
         <translation>Игнорировать include paths</translation>
     </message>
     <message>
-        <location filename="../src/OptionsWidget.ui" line="189"/>
+        <location filename="../src/OptionsWidget.ui" line="247"/>
         <source>Show binary&apos;s output</source>
         <translation>Показывать вывод программы</translation>
     </message>
     <message>
-        <location filename="../src/OptionsWidget.ui" line="196"/>
+        <location filename="../src/OptionsWidget.ui" line="294"/>
         <source>Show message Id on Issues</source>
         <translation>Показывать ИД ошибки</translation>
     </message>
@@ -101,33 +101,135 @@
         <source>Comma separated wildcards</source>
         <translation>Wildcards, разделенные запятыми</translation>
     </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="184"/>
+        <source>Saved header is checked within files that include it (recently used first). 0 checks header alone.</source>
+        <translation>Сохраненный заголовок проверяется вместе с включающими его файлами (сначала недавно использованными). 0 - проверять только заголовок.</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="187"/>
+        <source>Header&apos;s dependents to check:</source>
+        <translation>Зависимых файлов заголовка для проверки:</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="209"/>
+        <source>Do not check generated files (moc, uic, rcc and build directory outputs) and files of third-party directories on project checks.</source>
+        <translation>Не проверять при проверке проекта сгенерированные файлы (moc, uic, rcc и результаты сборки) и файлы сторонних каталогов.</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="212"/>
+        <source>Skip generated and third-party files</source>
+        <translation>Пропускать сгенерированные и сторонние файлы</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="221"/>
+        <source>Third-party directories:</source>
+        <translation>Сторонние каталоги:</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="231"/>
+        <source>Comma separated directory names</source>
+        <translation>Имена каталогов, разделенные запятыми</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="254"/>
+        <source>Keep analyzer information (--cppcheck-build-dir) and results between checks to skip unchanged files.</source>
+        <translation>Сохранять информацию анализатора (--cppcheck-build-dir) и результаты между проверками, чтобы пропускать неизмененные файлы.</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="257"/>
+        <source>Incremental check</source>
+        <translation>Инкрементальная проверка</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="266"/>
+        <source>Cache size limit:</source>
+        <translation>Ограничение размера кэша:</translation>
+    </message>
+    <message>
+        <location filename="../src/OptionsWidget.ui" line="276"/>
+        <source> MB</source>
+        <translation> МБ</translation>
+    </message>
+</context>
+<context>
+    <name>QtcCppcheck::Internal::CppcheckProcess</name>
+    <message>
+        <location filename="../src/CppcheckProcess.cpp" line="171"/>
+        <source>Cppcheck started</source>
+        <translation>Cppcheck запущен</translation>
+    </message>
+    <message>
+        <location filename="../src/CppcheckProcess.cpp" line="177"/>
+        <source>Cppcheck error occured</source>
+        <translation>Cppcheck ошибка программы</translation>
+    </message>
+    <message>
+        <location filename="../src/CppcheckProcess.cpp" line="207"/>
+        <source>Cppcheck finished</source>
+        <translation>Cppcheck завершил проверку</translation>
+    </message>
 </context>
 <context>
     <name>QtcCppcheck::Internal::CppcheckRunner</name>
     <message>
-        <location filename="../src/CppcheckRunner.cpp" line="247"/>
+        <location filename="../src/CppcheckRunner.cpp" line="1065"/>
         <source>Cppcheck</source>
         <translation>Cppcheck</translation>
     </message>
     <message>
-        <location filename="../src/CppcheckRunner.cpp" line="240"/>
-        <source>Cppcheck started</source>
-        <translation>Cppcheck запущен</translation>
+        <location filename="../src/CppcheckRunner.cpp" line="223"/>
+        <source>Cppcheck compilation database updated</source>
+        <translation>База данных компиляции Cppcheck обновлена</translation>
     </message>
     <message>
-        <location filename="../src/CppcheckRunner.cpp" line="166"/>
-        <source>Failed to write cppcheck&apos;s argument files</source>
-        <translation>Не удалось записать файлы с параметрами запуска cppcheck</translation>
+        <location filename="../src/CppcheckRunner.cpp" line="411"/>
+        <source>Cppcheck: %1 unchanged file(s) are not checked again</source>
+        <translation>Cppcheck: %1 неизмененных файл(ов) не проверяются повторно</translation>
     </message>
     <message>
-        <location filename="../src/CppcheckRunner.cpp" line="256"/>
-        <source>Cppcheck error occured</source>
-        <translation>Cppcheck ошибка программы</translation>
+        <location filename="../src/CppcheckRunner.cpp" line="628"/>
+        <source>Checked only %1 configuration(s) because checking all of them is too slow</source>
+        <translation>Проверено только %1 конфигурац(ий), так как проверка всех слишком медленная</translation>
     </message>
     <message>
-        <location filename="../src/CppcheckRunner.cpp" line="271"/>
-        <source>Cppcheck finished</source>
-        <translation>Cppcheck завершил проверку</translation>
+        <location filename="../src/CppcheckRunner.cpp" line="800"/>
+        <location filename="../src/CppcheckRunner.cpp" line="840"/>
+        <source>Cppcheck: checking of %1 failed, its previous results are kept</source>
+        <translation>Cppcheck: проверка %1 завершилась с ошибкой, предыдущие результаты сохранены</translation>
+    </message>
+    <message>
+        <location filename="../src/CppcheckRunner.cpp" line="804"/>
+        <source>Cppcheck: checking of %1 file(s) failed, their previous results are kept</source>
+        <translation>Cppcheck: проверка %1 файл(ов) завершилась с ошибкой, их предыдущие результаты сохранены</translation>
+    </message>
+    <message>
+        <location filename="../src/CppcheckRunner.cpp" line="1019"/>
+        <source>Cppcheck: search of unused functions failed, previous results are kept</source>
+        <translation>Cppcheck: поиск неиспользуемых функций завершился с ошибкой, предыдущие результаты сохранены</translation>
+    </message>
+    <message>
+        <location filename="../src/CppcheckRunner.cpp" line="1079"/>
+        <source>%1 left</source>
+        <translation>осталось %1</translation>
+    </message>
+    <message>
+        <location filename="../src/CppcheckRunner.cpp" line="1134"/>
+        <source>Cppcheck: %1 is too slow to check all configurations, checking only %2 of them</source>
+        <translation>Cppcheck: проверка всех конфигураций %1 слишком медленная, проверяются только %2 из них</translation>
+    </message>
+</context>
+<context>
+    <name>QtcCppcheck::Internal::CppcheckWorker</name>
+    <message>
+        <location filename="../src/CppcheckWorker.cpp" line="41"/>
+        <source>Failed to write cppcheck&apos;s project file</source>
+        <translation>Не удалось записать файл проекта для cppcheck</translation>
+    </message>
+    <message>
+        <location filename="../src/CppcheckWorker.cpp" line="91"/>
+        <source>Failed to write cppcheck&apos;s argument files</source>
+        <translation>Не удалось записать файлы с параметрами запуска cppcheck</translation>
     </message>
 </context>
 <context>
@@ -141,34 +243,44 @@
 <context>
     <name>QtcCppcheck::Internal::QtcCppcheckPlugin</name>
     <message>
-        <location filename="../src/QtcCppcheckPlugin.cpp" line="116"/>
+        <location filename="../src/QtcCppcheckPlugin.cpp" line="154"/>
         <source>Scan with cppcheck</source>
         <translation>Проверить Cppcheck</translation>
     </message>
     <message>
-        <location filename="../src/QtcCppcheckPlugin.cpp" line="128"/>
+        <location filename="../src/QtcCppcheckPlugin.cpp" line="166"/>
         <source>Check current &amp;project</source>
         <translation>Проверить &amp;проект</translation>
     </message>
     <message>
-        <location filename="../src/QtcCppcheckPlugin.cpp" line="135"/>
+        <location filename="../src/QtcCppcheckPlugin.cpp" line="173"/>
         <source>Check current &amp;document</source>
         <translation>Проверить &amp;документ</translation>
     </message>
     <message>
-        <location filename="../src/QtcCppcheckPlugin.cpp" line="144"/>
+        <location filename="../src/QtcCppcheckPlugin.cpp" line="182"/>
         <source>C&amp;ppcheck</source>
         <translation>C&amp;ppcheck</translation>
     </message>
     <message>
-        <location filename="../src/QtcCppcheckPlugin.cpp" line="132"/>
+        <location filename="../src/QtcCppcheckPlugin.cpp" line="170"/>
         <source>Alt+C,Ctrl+A</source>
         <translation>Alt+C,Ctrl+A</translation>
     </message>
     <message>
-        <location filename="../src/QtcCppcheckPlugin.cpp" line="139"/>
+        <location filename="../src/QtcCppcheckPlugin.cpp" line="177"/>
         <source>Alt+C,Ctrl+D</source>
         <translation>Alt+C,Ctrl+D</translation>
     </message>
+    <message>
+        <location filename="../src/QtcCppcheckPlugin.cpp" line="499"/>
+        <source>Cppcheck: %1 generated or third-party file(s) of project are not checked, about %2 s of check time saved</source>
+        <translation>Cppcheck: %1 сгенерированных или сторонних файл(ов) проекта не проверяются, сэкономлено около %2 с проверки</translation>
+    </message>
+    <message>
+        <location filename="../src/QtcCppcheckPlugin.cpp" line="835"/>
+        <source>Cppcheck: ignore pattern %1 is invalid and skipped</source>
+        <translation>Cppcheck: шаблон исключения %1 некорректен и пропущен</translation>
+    </message>
 </context>
 </TS>